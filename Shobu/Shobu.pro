@@ -17,6 +17,7 @@ DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    batchevaluator.cpp \
     board.cpp \
     boardstable.cpp \
     forwardthinkerlogic.cpp \
@@ -29,17 +30,23 @@ SOURCES += \
     greedylogic.cpp \
     hardlogic.cpp \
     machineplayer.cpp \
+    montecarlologic.cpp \
     main.cpp \
     onlinegamechooserdialog.cpp \
     organicplayer.cpp \
+    position.cpp \
     randomlogic.cpp \
+    searchlogic.cpp \
     shobuclient.cpp \
     shobumodel.cpp \
     shobupersistence.cpp \
     shobuview.cpp \
-    statecontrollerview.cpp
+    statecontrollerview.cpp \
+    symmetry.cpp \
+    transpositiontable.cpp
 
 HEADERS += \
+    batchevaluator.h \
     board.h \
     boardstable.h \
     forwardthinkerlogic.h \
@@ -54,16 +61,22 @@ HEADERS += \
     hardlogic.h \
     machinelogic.h \
     machineplayer.h \
+    montecarlologic.h \
     onlinegamechooserdialog.h \
     organicplayer.h \
+    parallelfor.h \
+    position.h \
     randomlogic.h \
+    searchlogic.h \
     shobuclient.h \
     shobuexception.h \
     shobumodel.h \
     shobupersistence.h \
     shobuplayer.h \
     shobuview.h \
-    statecontrollerview.h
+    statecontrollerview.h \
+    symmetry.h \
+    transpositiontable.h
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
@@ -0,0 +1,229 @@
+#include "batchevaluator.h"
+
+#include <QtAlgorithms>
+
+// the vector kernels are compiled for their own instruction sets and selected when the processor has them
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define BATCH_SIMD
+#include <immintrin.h>
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2  __attribute__((target("avx2")))
+#endif
+
+// PUBLIC
+
+// Constructor
+BatchEvaluator::BatchEvaluator()
+{
+    for (int i = 0; i < 16; ++i)
+    {
+        for (int j = 0; j < 8; ++j)
+        {
+            _weights[i][j] = 0;
+        }
+    }
+}
+
+// computes the terms of count positions into terms
+void BatchEvaluator::evaluate(const Position *positions, int count, EvaluationTerms *terms, Kernel kernel) const
+{
+    kernel = qMin(kernel, getKernel());
+    switch (kernel)
+    {
+    case AVX2:
+        evaluateAvx2(positions, count, terms);
+        break;
+    case SSE41:
+        evaluateSse41(positions, count, terms);
+        break;
+    default:
+        evaluateScalar(positions, count, terms);
+        break;
+    }
+}
+
+// the best kernel of the processor, checked once
+BatchEvaluator::Kernel BatchEvaluator::getKernel()
+{
+#ifdef BATCH_SIMD
+    static const Kernel kernel = []()
+    {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return AVX2;
+        }
+        if (__builtin_cpu_supports("sse4.1"))
+        {
+            return SSE41;
+        }
+        return SCALAR;
+    }();
+    return kernel;
+#else
+    return SCALAR;
+#endif
+}
+
+// PRIVATE
+
+// one position after the other, bit by bit
+void BatchEvaluator::evaluateScalar(const Position *positions, int count, EvaluationTerms *terms) const
+{
+    for (int n = 0; n < count; ++n)
+    {
+        const Position &position = positions[n];
+        EvaluationTerms &ret = terms[n];
+
+        ret.piece_square = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            for (int color = 0; color < 2; ++color)
+            {
+                quint16 mask = position._pieces[i][color];
+                ret.counts[i][color] = qPopulationCount(mask);
+                for (; mask; mask &= mask - 1)
+                {
+                    ret.piece_square += _weights[qCountTrailingZeroBits(mask)][i*2 + color];
+                }
+            }
+        }
+
+        for (int color = 0; color < 2; ++color)
+        {
+            ret.min_count[color] = qMin(qMin(ret.counts[0][color], ret.counts[1][color]), qMin(ret.counts[2][color], ret.counts[3][color]));
+            ret.min_boards[color] = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                if (ret.counts[i][color] == ret.min_count[color])
+                {
+                    ret.min_boards[color] |= 1 << i;
+                }
+            }
+        }
+    }
+}
+
+#ifdef BATCH_SIMD
+
+// number of set bits in each 16-bit lane
+TARGET_SSE41 static inline __m128i popcount16(__m128i masks)
+{
+    const __m128i nibbles = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m128i low = _mm_set1_epi8(0x0F);
+
+    __m128i bytes = _mm_add_epi8(_mm_shuffle_epi8(nibbles, _mm_and_si128(masks, low)),
+                                 _mm_shuffle_epi8(nibbles, _mm_and_si128(_mm_srli_epi16(masks, 4), low)));
+    return _mm_maddubs_epi16(bytes, _mm_set1_epi8(1)); // add the two bytes of each lane
+}
+
+// adds the eight 16-bit lanes
+TARGET_SSE41 static inline int horizontalSum16(__m128i values)
+{
+    __m128i sums = _mm_madd_epi16(values, _mm_set1_epi16(1));
+    sums = _mm_hadd_epi32(sums, sums);
+    sums = _mm_hadd_epi32(sums, sums);
+    return _mm_cvtsi128_si32(sums);
+}
+
+// fills the terms from the piece-square lanes and the counts, lanes are ordered as board*2 + color
+TARGET_SSE41 static inline void storeTerms(__m128i squares, __m128i counts, EvaluationTerms &terms)
+{
+    terms.piece_square = horizontalSum16(squares);
+
+    alignas(16) quint16 lanes[8];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), counts);
+    for (int i = 0; i < 8; ++i)
+    {
+        terms.counts[i/2][i%2] = static_cast<quint8>(lanes[i]);
+    }
+
+    // hide the lanes of the other color, minpos gives the smallest count
+    const __m128i black_lanes = _mm_setr_epi16(0, -1, 0, -1, 0, -1, 0, -1);
+    __m128i color_counts[2] = {_mm_or_si128(counts, black_lanes), _mm_or_si128(counts, _mm_xor_si128(black_lanes, _mm_set1_epi16(-1)))};
+    for (int color = 0; color < 2; ++color)
+    {
+        int min = _mm_cvtsi128_si32(_mm_minpos_epu16(color_counts[color])) & 0xFFFF;
+        int equal = _mm_movemask_epi8(_mm_cmpeq_epi16(color_counts[color], _mm_set1_epi16(static_cast<short>(min))));
+
+        terms.min_count[color] = static_cast<quint8>(min);
+        terms.min_boards[color] = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            if (equal & (1 << (i*4 + color*2))) // two bits for each lane
+            {
+                terms.min_boards[color] |= 1 << i;
+            }
+        }
+    }
+}
+
+// one position per step, the eight masks of a position fill a register
+TARGET_SSE41 void BatchEvaluator::evaluateSse41(const Position *positions, int count, EvaluationTerms *terms) const
+{
+    for (int n = 0; n < count; ++n)
+    {
+        __m128i masks = _mm_loadu_si128(reinterpret_cast<const __m128i *>(positions[n]._pieces));
+
+        __m128i squares = _mm_setzero_si128();
+        for (int field = 0; field < 16; ++field)
+        {
+            __m128i bit = _mm_set1_epi16(static_cast<short>(1 << field));
+            __m128i has_piece = _mm_cmpeq_epi16(_mm_and_si128(masks, bit), bit);
+            squares = _mm_add_epi16(squares, _mm_and_si128(has_piece, _mm_load_si128(reinterpret_cast<const __m128i *>(_weights[field]))));
+        }
+
+        storeTerms(squares, popcount16(masks), terms[n]);
+    }
+}
+
+// two positions per step, one in each half of the register
+TARGET_AVX2 void BatchEvaluator::evaluateAvx2(const Position *positions, int count, EvaluationTerms *terms) const
+{
+    const __m256i nibbles = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                             0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+
+    int n = 0;
+    for (; n + 1 < count; n += 2)
+    {
+        __m256i masks = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(positions[n]._pieces))),
+                                                _mm_loadu_si128(reinterpret_cast<const __m128i *>(positions[n+1]._pieces)), 1);
+
+        __m256i squares = _mm256_setzero_si256();
+        for (int field = 0; field < 16; ++field)
+        {
+            __m256i bit = _mm256_set1_epi16(static_cast<short>(1 << field));
+            __m256i has_piece = _mm256_cmpeq_epi16(_mm256_and_si256(masks, bit), bit);
+            __m256i weights = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(_weights[field])));
+            squares = _mm256_add_epi16(squares, _mm256_and_si256(has_piece, weights));
+        }
+
+        __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(nibbles, _mm256_and_si256(masks, low)),
+                                        _mm256_shuffle_epi8(nibbles, _mm256_and_si256(_mm256_srli_epi16(masks, 4), low)));
+        __m256i counts = _mm256_maddubs_epi16(bytes, _mm256_set1_epi8(1));
+
+        storeTerms(_mm256_castsi256_si128(squares), _mm256_castsi256_si128(counts), terms[n]);
+        storeTerms(_mm256_extracti128_si256(squares, 1), _mm256_extracti128_si256(counts, 1), terms[n+1]);
+    }
+
+    if (n < count) // odd one out
+    {
+        evaluateSse41(positions + n, count - n, terms + n);
+    }
+}
+
+#else
+
+// without vector instructions every kernel is the scalar one
+void BatchEvaluator::evaluateSse41(const Position *positions, int count, EvaluationTerms *terms) const
+{
+    evaluateScalar(positions, count, terms);
+}
+
+void BatchEvaluator::evaluateAvx2(const Position *positions, int count, EvaluationTerms *terms) const
+{
+    evaluateScalar(positions, count, terms);
+}
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef BATCHEVALUATOR_H
+#define BATCHEVALUATOR_H
+
+#include <QtGlobal>
+
+#include "position.h"
+
+// Terms of a position computed by the BatchEvaluator, the machine logics make their scores from them
+struct EvaluationTerms
+{
+    int piece_square;      // sum of the weights of every piece on its field
+    quint8 counts[4][2];   // number of pieces for each board and color
+    quint8 min_count[2];   // number of pieces on the weakest board of each color
+    quint8 min_boards[2];  // one bit for each board that has min_count pieces of the color
+};
+
+// Computes the EvaluationTerms of many positions at once, with AVX2 or SSE4.1 when the processor has them
+class BatchEvaluator
+{
+public:
+    enum Kernel
+    {
+        SCALAR = 0,
+        SSE41  = 1, // one position per step
+        AVX2   = 2  // two positions per step
+    };
+
+    BatchEvaluator(); // every weight is zero
+
+    void setWeight(int board_id, Color color, int field, int weight) {_weights[field][board_id*2 + color] = static_cast<qint16>(weight);}
+
+    void evaluate(const Position *positions, int count, EvaluationTerms *terms) const {evaluate(positions, count, terms, getKernel());}
+    void evaluate(const Position *positions, int count, EvaluationTerms *terms, Kernel kernel) const; // kernel is lowered to what the processor has
+
+    static Kernel getKernel(); // the best kernel of the processor
+
+private:
+    alignas(16) qint16 _weights[16][8]; // indexed by field and board*2 + color, the order of the masks in Position
+
+    void evaluateScalar(const Position *positions, int count, EvaluationTerms *terms) const;
+    void evaluateSse41(const Position *positions, int count, EvaluationTerms *terms) const;
+    void evaluateAvx2(const Position *positions, int count, EvaluationTerms *terms) const;
+};
+
+#endif // BATCHEVALUATOR_H
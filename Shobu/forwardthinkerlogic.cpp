@@ -2,6 +2,8 @@
 
 #include <QDebug>
 
+#include "symmetry.h"
+
 enum ForwardThinkerValues
 {
     DEPTH           =       2,  // the depth of the search tree
@@ -22,7 +24,9 @@ ForwardThinkerLogic::ForwardThinkerLogic(GameState *state, Color color, QObject
 // returns the best move to the machineplayer
 Move ForwardThinkerLogic::getMove()
 {
-    QVector<Move> moves = _state->getMoves();
+    Position position = _state->getPosition(); // search on a copy, the game is not touched
+    MoveList moves;
+    Symmetry::getUniqueMoves(position, moves); // symmetric children have the same score
 
     if(moves.isEmpty())
     {
@@ -40,15 +44,15 @@ Move ForwardThinkerLogic::getMove()
     {
 
         //GameState *moved_state = _state->getApplied(moves[i]);
-        ReverseData reverse = _state->applyMove(moves[i]);
+        ReverseData reverse = position.applyUnchecked(moves[i]);
         //int score = evaluateState(1, DEPTH-1, alpha, beta);
-        int score = alphaBeta(DEPTH - 1, true, -MAXIMUM_INIT, MAXIMUM_INIT);
+        int score = alphaBeta(position, DEPTH - 1, true, -MAXIMUM_INIT, MAXIMUM_INIT);
         if(score > max)
         {
             index = i;
             max = score;
         }
-        _state->reverseMove(moves[i], reverse);
+        position.reverseUnchecked(moves[i], reverse);
     }
     qDebug()<<test;
     test = 0;
@@ -56,13 +60,14 @@ Move ForwardThinkerLogic::getMove()
 }
 
 // gives a score to the current state
-int ForwardThinkerLogic::evaluateState(int sign,  int level, int alpha, int beta)
+int ForwardThinkerLogic::evaluateState(Position &position, int sign, int level, int alpha, int beta)
 {
-    if(_state->getVictor() == _state->getTurn())
+    if(position.getVictor() == position.getTurn())
     {
         return VICTORY * sign; // highest possible return value
     }
-    QVector<Move> moves = _state->getMoves();
+    MoveList moves;
+    position.getMoves(moves);
 
     if(moves.isEmpty())
     {
@@ -71,7 +76,7 @@ int ForwardThinkerLogic::evaluateState(int sign,  int level, int alpha, int beta
 
     if (level < 1)
     {
-        return evaluateLeaf() * sign;
+        return evaluateLeaf(position) * sign;
     }
 
 
@@ -82,25 +87,25 @@ int ForwardThinkerLogic::evaluateState(int sign,  int level, int alpha, int beta
     {
 
         //GameState *moved_state = _state->getApplied(moves[i]);
-        ReverseData reverse = _state->applyMove(moves[i]);
+        ReverseData reverse = position.applyUnchecked(moves[i]);
 
-        int score = evaluateState(sign * -1, level - 1, alpha, beta) * sign;
+        int score = evaluateState(position, sign * -1, level - 1, alpha, beta) * sign;
         //qDebug()<<score;
         if(score > max)
         {
 
             max = score;
         }
-        _state->reverseMove(moves[i], reverse);
+        position.reverseUnchecked(moves[i], reverse);
         //delete moved_state;
     }
     return max * sign;
 }
 
 // uses alpha beta algorithm to find move with the best score
-int ForwardThinkerLogic::alphaBeta(int level, bool is_maxing, int alpha, int beta)
+int ForwardThinkerLogic::alphaBeta(Position &position, int level, bool is_maxing, int alpha, int beta)
 {
-    if(Color victor = _state->getVictor(); victor != EMPTY)
+    if(Color victor = position.getVictor(); victor != EMPTY)
     {
         if(victor == side)
         {
@@ -112,11 +117,9 @@ int ForwardThinkerLogic::alphaBeta(int level, bool is_maxing, int alpha, int bet
         }
     }
 
-    QVector<Move> moves = _state->getMoves();
-
-    if(moves.isEmpty())
+    if(!position.hasMoves())
     {
-        if(_state->getTurn() == side)
+        if(position.getTurn() == side)
         {
             return -VICTORY;
         }
@@ -128,50 +131,54 @@ int ForwardThinkerLogic::alphaBeta(int level, bool is_maxing, int alpha, int bet
 
     if (level < 1)
     {
-        return evaluateLeaf();
+        return evaluateLeaf(position);
     }
 
     int score;
     if(is_maxing)
     {
         score = -MAXIMUM_INIT;
-        for (int i = 0; i < moves.length(); ++i)
+        StagedMoves moves(position); // pushes first, quiet moves are only generated if there is no cut before them
+        PackedMove move;
+        while (moves.next(move))
         {
-            ReverseData reverse = _state->applyMove(moves[i]);
-            int value = alphaBeta(level - 1, !is_maxing, alpha, beta);
+            ReverseData reverse = position.applyUnchecked(move);
+            int value = alphaBeta(position, level - 1, !is_maxing, alpha, beta);
             score = value > score ? value : score;
             alpha = score > alpha ? score : alpha;
+            position.reverseUnchecked(move, reverse);
             if(alpha >= beta)
             {
-                i = moves.length();
+                break;
             }
-            _state->reverseMove(moves[i], reverse);
         }
     }
     else
     {
         score = MAXIMUM_INIT;
-        for (int i = 0; i < moves.length(); ++i)
+        StagedMoves moves(position); // pushes first, quiet moves are only generated if there is no cut before them
+        PackedMove move;
+        while (moves.next(move))
         {
-            ReverseData reverse = _state->applyMove(moves[i]);
-            int value = alphaBeta(level - 1, !is_maxing, alpha, beta);
+            ReverseData reverse = position.applyUnchecked(move);
+            int value = alphaBeta(position, level - 1, !is_maxing, alpha, beta);
             score = value < score ? value : score;
             alpha = score < alpha ? score : alpha;
+            position.reverseUnchecked(move, reverse);
             if(alpha >= beta)
             {
-                i = moves.length();
+                break;
             }
-            _state->reverseMove(moves[i], reverse);
         }
     }
     return score;
 }
 
 // gives a score to the current state
-int ForwardThinkerLogic::evaluateLeaf()
+int ForwardThinkerLogic::evaluateLeaf(const Position &position)
 {
     ++test;
-    if (Color victor = _state->getVictor(); victor != EMPTY)
+    if (Color victor = position.getVictor(); victor != EMPTY)
     {
         if(victor == side)
         {
@@ -204,13 +211,13 @@ int ForwardThinkerLogic::evaluateLeaf()
             //int board_min = 0;
             for (int k = 0; k < 4; ++k)
             {
-                if (_state->getField(i,j,k) != EMPTY)
+                if (position.getField(i,j,k) != EMPTY)
                 {
-                    ++piece_count[_state->getField(i,j,k)][i];
+                    ++piece_count[position.getField(i,j,k)][i];
 
-                    if(_state->getField(i,j,k) == side)
+                    if(position.getField(i,j,k) == side)
                     {
-                        if(_state->isHomeBoard(side, i))
+                        if(position.isHomeBoard(side, i))
                         {
                             score += sideHomeValues[j][k];
                         }
@@ -221,7 +228,7 @@ int ForwardThinkerLogic::evaluateLeaf()
                     }
                     else
                     {
-                        if(_state->isHomeBoard(side, i))
+                        if(position.isHomeBoard(side, i))
                         {
                             score += opponentHomeValues[j][k];
                         }
@@ -237,7 +244,7 @@ int ForwardThinkerLogic::evaluateLeaf()
 
     }
     /*score -= min*MIN_MULTIPLIER;
-    if(_state->isHomeBoard(opponent, index))
+    if(position.isHomeBoard(opponent, index))
     {
         ++score;
     }
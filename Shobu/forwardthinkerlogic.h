@@ -15,9 +15,9 @@ private:
     Color side, opponent;
     int test;
 
-    int evaluateState(int sign, int level, int alpha, int beta);
-    int alphaBeta(int level, bool is_maxing, int alpha, int beta);
-    int evaluateLeaf();
+    int evaluateState(Position &position, int sign, int level, int alpha, int beta);
+    int alphaBeta(Position &position, int level, bool is_maxing, int alpha, int beta);
+    int evaluateLeaf(const Position &position);
 
 
     // position values
@@ -187,10 +187,7 @@ void GameControllerView::leaveGameClicked()
 
     if (msg.exec() == QMessageBox::Accepted)
     {
-        if (_model->getTicking()) // if timer is on, stop it
-        {
-            _model->changeTime();
-        }
+        _model->endGame(); // stop the timer and the machine player
         if (_model->getSettings().style == NETWORK) // give up if network game
         {
             _model->disconnectFromServer();
@@ -33,6 +33,8 @@ GameSettingsDialog::GameSettingsDialog(GameStyle style, QWidget *parent) : QDial
     _settings.color      = WHITE;
     _settings.difficulty = MEDIUM;
     _settings.has_time   = false;
+    _settings.pondering  = false;
+    _settings.monte_carlo = false;
     _settings.time       = STARTINGTIME;
     _settings.times[0]   = STARTINGTIME;
     _settings.times[1]   = STARTINGTIME;
@@ -134,7 +136,7 @@ void GameSettingsDialog::setupWindow()
     QObject::connect(_decrease_difficulty, &QPushButton::clicked, this, &GameSettingsDialog::difficultyDecrease);
     _layout->addWidget(_decrease_difficulty,current_row,0,1,1,Qt::AlignRight);
 
-    QString difficulty_text[3] = {"EASY", "MEDIUM", "HARD"};
+    QString difficulty_text[4] = {"EASY", "MEDIUM", "HARD", "EXPERT"};
     _difficulty = new QLabel(difficulty_text[_settings.difficulty]);
     _difficulty->setFont(font);
     _difficulty->setAlignment(Qt::AlignCenter);
@@ -157,6 +159,56 @@ void GameSettingsDialog::setupWindow()
         _increase_difficulty->setVisible(false);
     }
 
+    // pondering setter
+    _pondering_label = new QLabel("Ponder:");
+    _pondering_label->setFont(font);
+
+    _pondering = new QCheckBox();
+    _pondering->setChecked(_settings.pondering);
+    QObject::connect(_pondering, &QCheckBox::stateChanged, this, &GameSettingsDialog::ponderingChange);
+    _layout->addWidget(_pondering_label,current_row,0,1,1,Qt::AlignCenter);
+    _layout->addWidget(_pondering,    current_row++,1,1,1,Qt::AlignCenter);
+    // pondering only needed in solo mode
+    if (_settings.style != SOLO)
+    {
+        _pondering_label->setEnabled(false);
+        _pondering_label->setVisible(false);
+
+        _pondering->setEnabled(false);
+        _pondering->setVisible(false);
+    }
+    // only the expert machine player ponders
+    else
+    {
+        _pondering_label->setEnabled(_settings.difficulty == EXPERT);
+        _pondering->setEnabled(_settings.difficulty == EXPERT);
+    }
+
+    // search setter
+    _monte_carlo_label = new QLabel("Monte Carlo:");
+    _monte_carlo_label->setFont(font);
+
+    _monte_carlo = new QCheckBox();
+    _monte_carlo->setChecked(_settings.monte_carlo);
+    QObject::connect(_monte_carlo, &QCheckBox::stateChanged, this, &GameSettingsDialog::monteCarloChange);
+    _layout->addWidget(_monte_carlo_label,current_row,0,1,1,Qt::AlignCenter);
+    _layout->addWidget(_monte_carlo,    current_row++,1,1,1,Qt::AlignCenter);
+    // search only chosen in solo mode
+    if (_settings.style != SOLO)
+    {
+        _monte_carlo_label->setEnabled(false);
+        _monte_carlo_label->setVisible(false);
+
+        _monte_carlo->setEnabled(false);
+        _monte_carlo->setVisible(false);
+    }
+    // only the expert machine player can change its search
+    else
+    {
+        _monte_carlo_label->setEnabled(_settings.difficulty == EXPERT);
+        _monte_carlo->setEnabled(_settings.difficulty == EXPERT);
+    }
+
     // submit buttons
     _reject = new QPushButton("Cancel");
     _reject->setFont(font);
@@ -244,22 +296,40 @@ void GameSettingsDialog::difficultyIncrease()
         _difficulty->setText("MEDIUM");
         _decrease_difficulty->setEnabled(true);
     }
-    else
+    else if (_settings.difficulty == MEDIUM)
     {
         _settings.difficulty = HARD;
         _difficulty->setText("HARD");
+    }
+    else
+    {
+        _settings.difficulty = EXPERT;
+        _difficulty->setText("EXPERT");
         _increase_difficulty->setEnabled(false);
+        _pondering_label->setEnabled(true);
+        _pondering->setEnabled(true);
+        _monte_carlo_label->setEnabled(true);
+        _monte_carlo->setEnabled(true);
     }
 }
 
 // decrease difficulty of return value
 void GameSettingsDialog::difficultyDecrease()
 {
-    if (_settings.difficulty == HARD)
+    if (_settings.difficulty == EXPERT)
+    {
+        _settings.difficulty = HARD;
+        _difficulty->setText("HARD");
+        _increase_difficulty->setEnabled(true);
+        _pondering_label->setEnabled(false);
+        _pondering->setEnabled(false);
+        _monte_carlo_label->setEnabled(false);
+        _monte_carlo->setEnabled(false);
+    }
+    else if (_settings.difficulty == HARD)
     {
         _settings.difficulty = MEDIUM;
         _difficulty->setText("MEDIUM");
-        _increase_difficulty->setEnabled(true);
     }
     else
     {
@@ -268,3 +338,15 @@ void GameSettingsDialog::difficultyDecrease()
         _decrease_difficulty->setEnabled(false);
     }
 }
+
+// update pondering of return value
+void GameSettingsDialog::ponderingChange()
+{
+    _settings.pondering = !_settings.pondering;
+}
+
+// update search of return value
+void GameSettingsDialog::monteCarloChange()
+{
+    _settings.monte_carlo = !_settings.monte_carlo;
+}
@@ -38,12 +38,16 @@ private:
     QPushButton *_accept;
 
     QCheckBox *_has_time;
+    QCheckBox *_pondering;
+    QCheckBox *_monte_carlo;
 
     QLabel *_box_title;
     QLabel *_color_label;
     QLabel *_has_time_label;
     QLabel *_time;
     QLabel *_difficulty;
+    QLabel *_pondering_label;
+    QLabel *_monte_carlo_label;
 
     // functions
     void setupWindow();
@@ -55,6 +59,8 @@ private:
     void timeDecrease();
     void difficultyIncrease();
     void difficultyDecrease();
+    void ponderingChange();
+    void monteCarloChange();
 };
 
 #endif // GAMESETTINGSDIALOG_H
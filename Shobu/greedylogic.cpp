@@ -2,12 +2,14 @@
 
 #include <QRandomGenerator>
 
+#include "parallelfor.h"
 #include "shobuexception.h"
 
 enum GreedyValues
 {
     GREEDY_MIN = 2,          // how important is min value related to piece count
-    GREEDY_MULTIPLIER = 100  // multiply everything except random with this
+    GREEDY_MULTIPLIER = 100, // multiply everything except random with this
+    CHUNK_SIZE = 32          // moves scored together by one thread
 };
 
 // PUBLIC
@@ -18,7 +20,9 @@ GreedyLogic::GreedyLogic(GameState *state, QObject *parent) : MachineLogic(state
 // returns the best move to the machineplayer
 Move GreedyLogic::getMove()
 {
-    QVector<Move> moves = _state->getMoves();
+    Position position = _state->getPosition(); // search on a copy, the game is not touched
+    MoveList moves;
+    position.getMoves(moves);
 
     if (moves.isEmpty()) // can not return a legal move when there are no legal moves
     {
@@ -27,71 +31,70 @@ Move GreedyLogic::getMove()
         exept_ptr->raise();
     }
 
-    int index = 0;
-
-    GameState *moved_state = _state->getApplied(moves[0]);
+    // score the moves in chunks, each chunk evaluates its own copies of the position in one batch
+    QVector<int> scores(moves.length());
+    parallelFor(moves.length(), _thread_count, CHUNK_SIZE, [&](int begin, int end)
+    {
+        if (isCancelled()) // the move of a cancelled search is dropped, the remaining chunks are skipped
+        {
+            return;
+        }
+        Position children[CHUNK_SIZE];
+        EvaluationTerms terms[CHUNK_SIZE];
+        for (int i = begin; i < end; ++i)
+        {
+            children[i-begin] = position;
+            children[i-begin].applyUnchecked(moves[i]);
+        }
+        _evaluator.evaluate(children, end - begin, terms);
+        for (int i = begin; i < end; ++i)
+        {
+            scores[i] = evaluateState(terms[i-begin], children[i-begin].getTurn());
+        }
+    });
 
-    int max = evaluateState(moved_state);
+    int index = 0;
+    int max = 0;
 
-    for (int i = 1; i < moves.length(); ++i) // find move with the highest score
+    // find move with the highest score in move order, so the random values and ties are the same with any number of threads
+    for (int i = 0; i < moves.length(); ++i)
     {
-        delete moved_state;
-        moved_state = _state->getApplied(moves[i]);
+        int score = scores[i] + QRandomGenerator::global()->bounded(0,GREEDY_MULTIPLIER/2); // random has to be less than any relevant score
 
-        int score = evaluateState(moved_state);
-        if (score > max)
+        if (i == 0 || score > max)
         {
             index = i;
             max = score;
         }
     }
-    delete moved_state;
     return moves[index];
 }
 
 // PRIVATE
 
-// gives a score to a given state
-int GreedyLogic::evaluateState(const GameState *state)
+// gives a score to a state from its terms without the random part, the opponent is the current player after our move
+int GreedyLogic::evaluateState(const EvaluationTerms &terms, Color opponent)
 {
     int score = 20; // the opponent has at most 16 pieces with a minimum of 4 per board
 
-    Color opponent = state->getTurn(); // the current player after our move is the opponent
-
-    int min = 5;
-    int index = 0;
-
-    // count pieces on each boaed for both players
+    // count pieces on each board of the opponent
     for (int i = 0; i < 4; ++i)
     {
-        int board_min = 0; // find board with the fewest opposing pieces
-        for (int j = 0; j < 4; ++j)
-        {
-            for (int k = 0; k < 4; ++k)
-            {
-                if (state->getField(i,j,k) == opponent)
-                {
-                    --score;
-                    ++board_min;
-                }
-            }
-        }
-        if (min > board_min || (min > board_min && state->isHomeBoard(opponent, i)))
-        {
-            min = board_min;
-            index = i;
-        }
+        score -= terms.counts[i][opponent];
     }
+
+    // find the first board with the fewest opposing pieces
+    int min = terms.min_count[opponent];
+    int index = qCountTrailingZeroBits(terms.min_boards[opponent]);
+
     score -= (min*GREEDY_MIN); // always hit in the board closest to victory
 
     score = score * GREEDY_MULTIPLIER;
 
-    if (state->isHomeBoard(opponent, index)) // score for preferred board is less than a piece score
+    if (Position::isHomeBoard(opponent, index)) // score for preferred board is less than a piece score
     {
         score += GREEDY_MULTIPLIER/2;
     }
 
-    score += QRandomGenerator::global()->bounded(0,GREEDY_MULTIPLIER/2); // random has to be less than any relevant score
-
     return score;
 }
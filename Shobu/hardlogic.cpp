@@ -1,7 +1,9 @@
 #include "hardlogic.h"
 
 #include <QRandomGenerator>
+#include <QtAlgorithms>
 
+#include "parallelfor.h"
 #include "shobuexception.h"
 
 enum EvaluateValues
@@ -11,7 +13,8 @@ enum EvaluateValues
     PIECE_VALUE =        100, // score for one piece on a board
     HOME_BONUS  =         10, // score for having one of the opponent's homeboard as the weakest
     WEAKEST     =         10, // multiplier for the weakest board piece penalty
-    RAND_BOUND  =          5  // exclusive maximum of random value given to the score
+    RAND_BOUND  =          5, // exclusive maximum of random value given to the score
+    CHUNK_SIZE  =         16  // moves scored together by one thread
 };
 
 // PUBLIC
@@ -20,12 +23,26 @@ enum EvaluateValues
 HardLogic::HardLogic(GameState *state, Color color, QObject *parent) : MachineLogic(state, parent), _side(color)
 {
     _opponent = _state->getOpponent(_side);
+
+    // a piece is worth its value and the value of its field
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int field = 0; field < 16; ++field)
+        {
+            int row = field/4;
+            int column = field%4;
+            _evaluator.setWeight(i, _side, field, PIECE_VALUE + (Position::isHomeBoard(_side, i) ? sideHomeValues[row][column] : sideOpposingValues[row][column]));
+            _evaluator.setWeight(i, _opponent, field, -PIECE_VALUE + (Position::isHomeBoard(_opponent, i) ? opponentHomeValues[row][column] : opponentOpposingValues[row][column]));
+        }
+    }
 }
 
 // returns the best move to the machineplayer
 Move HardLogic::getMove()
 {
-    QVector<Move> moves = _state->getMoves();
+    Position position = _state->getPosition(); // search on a copy, the game is not touched
+    MoveList moves;
+    position.getMoves(moves);
 
     if (moves.isEmpty()) // can not return a legal move when there are no legal moves
     {
@@ -34,19 +51,44 @@ Move HardLogic::getMove()
         exept_ptr->raise();
     }
 
+    // score the moves in chunks, each chunk evaluates its own copies of the position in one batch
+    QVector<int> scores(moves.length());
+    parallelFor(moves.length(), _thread_count, CHUNK_SIZE, [&](int begin, int end)
+    {
+        if (isCancelled()) // the move of a cancelled search is dropped, the remaining chunks are skipped
+        {
+            return;
+        }
+        Position children[CHUNK_SIZE];
+        EvaluationTerms terms[CHUNK_SIZE];
+        for (int i = begin; i < end; ++i)
+        {
+            children[i-begin] = position;
+            children[i-begin].applyUnchecked(moves[i]);
+        }
+        _evaluator.evaluate(children, end - begin, terms);
+        for (int i = begin; i < end; ++i)
+        {
+            scores[i] = evaluateState(children[i-begin], terms[i-begin]);
+        }
+    });
+
     int index = -1;
     int max = -UNREACHABLE; // initial minimum must always be surpassed
 
+    // in move order, so the random values and the first of the best moves are the same with any number of threads
     for (int i = 0; i < moves.length(); ++i)
     {
-        ReverseData reverse = _state->applyMove(moves[i]);
-        int score = evaluateState();
+        int score = scores[i];
+        if (qAbs(score) != MAX_SCORE)
+        {
+            score += QRandomGenerator::global()->bounded(0,RAND_BOUND); // random has to be less than any relevant score
+        }
         if (score > max)
         {
             index = i;
             max = score;
         }
-        _state->reverseMove(moves[i], reverse);
     }
 
     return moves[index];
@@ -54,107 +96,37 @@ Move HardLogic::getMove()
 
 // PRIVATE
 
-// gives a score to a given state
-int HardLogic::evaluateState()
+// gives a score to a given state from its terms, without the random part
+int HardLogic::evaluateState(const Position &position, const EvaluationTerms &terms)
 {
-    int score = 0;
-
-    int piece_count[4][2] = { // pieces
-        {0,0},
-        {0,0},
-        {0,0},
-        {0,0}};
-
-    // count pieces on each board for both players
-    for (int i = 0; i < 4; ++i)
-    {
-        for (int j = 0; j < 4; ++j)
-        {
-            for (int k = 0; k < 4; ++k)
-            {
-                if (Color color = _state->getField(i,j,k); color != EMPTY)
-                {
-                    // count piece
-                    ++piece_count[i][color];
-
-                    // add position value to score
-                    if (color == _side)
-                    {
-                        score += PIECE_VALUE;
-                        if (GameState::isHomeBoard(color, i))
-                        {
-                            score += sideHomeValues[j][k];
-                        }
-                        else
-                        {
-                            score += sideOpposingValues[j][k];
-                        }
-                    }
-                    else
-                    {
-                        score += -PIECE_VALUE;
-                        if (GameState::isHomeBoard(color, i))
-                        {
-                            score += opponentHomeValues[j][k];
-                        }
-                        else
-                        {
-                            score += opponentOpposingValues[j][k];
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-    // find minimum piece count of each player
-    int color_min[2] = {0,0};
-
-    for (int i = 1; i < 4; ++i)
-    {
-        if (piece_count[color_min[_side]][_side] > piece_count[i][_side])
-        {
-            color_min[_side] = i;
-        }
-        if (piece_count[color_min[_opponent]][_opponent] > piece_count[i][_opponent])
-        {
-            color_min[_opponent] = i;
-        }
-        else if (piece_count[color_min[_opponent]][_opponent] == piece_count[i][_opponent] && _state->isHomeBoard(_opponent, i))
-        {
-            color_min[_opponent] = i; // we prefer the homeboard to be the weakest
-        }
-    }
+    int score = terms.piece_square; // position values of the pieces on each board for both players
 
-    if (piece_count[color_min[_opponent]][_opponent] == 0) // victory is always the best option
+    if (terms.min_count[_opponent] == 0) // victory is always the best option
     {
         return MAX_SCORE;
     }
 
-    if (piece_count[color_min[_side]][_side] == 1) // do not pick moves ending in our defeat
+    if (terms.min_count[_side] == 1) // do not pick moves ending in our defeat
     {
-        QVector<Move> moves = _state->getMoves();
+        MoveList moves;
+        position.getPushOffs(moves); // only a push off can empty a board
 
-        for (int i = 0; i < moves.length(); ++i) // check all possible moves from opponent
+        for (int i = 0; i < moves.length(); ++i) // check the push offs of the opponent
         {
-            ReverseData reverse = _state->applyMove(moves[i]);
-            if (_state->getVictor() != EMPTY) // if opponent can win, this move is bad
+            if (terms.counts[moves[i].agressiveBoard()][_side] == 1) // if opponent can win, this move is bad
             {
-                _state->reverseMove(moves[i], reverse);
                 return -MAX_SCORE;
             }
-            _state->reverseMove(moves[i], reverse);
         }
     }
 
-    score += -piece_count[color_min[_opponent]][_opponent]*WEAKEST; // add penalty for pieces on opponent's weakest board
+    score += -terms.min_count[_opponent]*WEAKEST; // add penalty for pieces on opponent's weakest board
 
-    if (_state->isHomeBoard(_opponent, color_min[_opponent])) // award if opponent homeboard is the weakest
+    int home_boards = _opponent == BLACK ? 0x3 : 0xC; // boards 0 and 1 or 2 and 3
+    if (terms.min_boards[_opponent] & home_boards) // award if opponent homeboard is the weakest, we prefer it on ties
     {
         score += HOME_BONUS;
     }
 
-    score += QRandomGenerator::global()->bounded(0,RAND_BOUND); // random has to be less than any relevant score
-
     return score;
 }
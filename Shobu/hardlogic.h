@@ -2,6 +2,7 @@
 #define HARDLOGIC_H
 
 #include "machinelogic.h"
+#include "batchevaluator.h"
 
 class HardLogic : public MachineLogic
 {
@@ -13,8 +14,9 @@ public:
 
 private:
     Color _side, _opponent;
+    BatchEvaluator _evaluator; // weighted with the position values below
 
-    int evaluateState();
+    int evaluateState(const Position &position, const EvaluationTerms &terms);
 
     // position values
     int sideHomeValues[4][4] =
@@ -1,39 +1,177 @@
 #include "machineplayer.h"
 
+#include <QScopedPointer>
+#include <QThread>
+
 #include "randomlogic.h"
 #include "greedylogic.h"
 #include "hardlogic.h"
+#include "searchlogic.h"
+#include "montecarlologic.h"
 #include "shobuexception.h"
 
 // PUBLIC
 
 // Constructor
-MachinePlayer::MachinePlayer(MoveState *m_state, Color color, Difficulty difficulty, QObject *parent) : ShobuPlayer(m_state, color, parent)
+MachinePlayer::MachinePlayer(MoveState *m_state, Color color, Difficulty difficulty, QObject *parent) : ShobuPlayer(m_state, color, parent),
+    _difficulty(difficulty), _monte_carlo(false), _search_id(0), _search_count(0),
+    _pondering(false), _ponder_search(false), _has_ponder_move(false)
 {
+    _search_state = new GameState(this);
+
     switch (difficulty)
     {
     case EASY:
-        _logic = new RandomLogic(state->game, this);
+        _logic = new RandomLogic(_search_state, this);
         break;
     case MEDIUM:
-        _logic = new GreedyLogic(state->game, this);
+        _logic = new GreedyLogic(_search_state, this);
+        _logic->setThreadCount(QThread::idealThreadCount());
         break;
     case HARD:
-        _logic = new HardLogic(state->game, color, this);
+        _logic = new HardLogic(_search_state, color, this);
+        _logic->setThreadCount(QThread::idealThreadCount());
+        break;
+    case EXPERT:
+        _logic = new SearchLogic(_search_state, this);
+        _logic->setThreadCount(QThread::idealThreadCount());
         break;
     default:
-        _logic = new RandomLogic(state->game, this);
+        _logic = new RandomLogic(_search_state, this);
         break;
     }
 }
 
-// gets a move form the machinelogic and notifies the logic
+// Destructor
+MachinePlayer::~MachinePlayer()
+{
+    cancelMove(); // the worker uses the logic
+}
+
+// starts the search of the machinelogic on a worker thread, onMoveFound notifies the logic
 void MachinePlayer::makeMove()
 {
-    state->move = _logic->getMove();
+    if (_ponder_search && _search_state->getPosition() == state->game->getPosition()) // ponder hit, the search goes on with its budget
+    {
+        _ponder_search = false;
+        _logic->setPondering(false);
+        if (_has_ponder_move) // the search ended during the turn of the other player
+        {
+            _has_ponder_move = false;
+            int search_id = _search_id;
+            Move move = _ponder_move;
+            QMetaObject::invokeMethod(this, [this, search_id, move]() {onMoveFound(search_id, move);}, Qt::QueuedConnection);
+        }
+        return;
+    }
+
+    cancelMove(); // only one search at a time, after a ponder miss the logic keeps what is still valid
+
+    if (!state->game->hasMoves()) // the worker thread could not report it
+    {
+        QScopedPointer<ShobuException> exept_ptr(new ShobuException());
+        exept_ptr->setMessage("No available moves to select from");
+        exept_ptr->raise();
+    }
+
+    startSearch(state->game->getPosition());
+}
+
+// stops the search in progress, its move is dropped
+void MachinePlayer::cancelMove()
+{
+    ++_search_id;
+    _ponder_search = false;
+    _has_ponder_move = false;
+    if (_worker.joinable())
+    {
+        _logic->cancel();
+        _worker.join();
+    }
+    _logic->setPondering(false);
+}
+
+// searches the position after the expected move of the other player, if the logic can tell it
+void MachinePlayer::ponder()
+{
+    cancelMove();
+
+    PackedMove expected_move;
+    if (!_pondering || state->game->getTurn() == side || state->game->getVictor() != EMPTY
+        || !_logic->getPonderMove(state->game->getPosition(), expected_move))
+    {
+        return;
+    }
+    Position expected = state->game->getPosition();
+    expected.applyUnchecked(expected_move);
+    if (expected.getVictor() != EMPTY || !expected.hasMoves()) // the game ends with the expected move
+    {
+        return;
+    }
+
+    _logic->setPondering(true);
+    _ponder_search = true;
+    _expected_move = expected_move;
+    startSearch(expected);
+}
+
+void MachinePlayer::makeMove(Move) {} // machineplayer does not accept input
+
+// the expert machine player searches with the MonteCarloLogic instead of the SearchLogic
+void MachinePlayer::setMonteCarlo(bool monte_carlo)
+{
+    if (_difficulty != EXPERT || monte_carlo == _monte_carlo)
+    {
+        return;
+    }
+
+    cancelMove(); // the worker uses the logic
+    delete _logic;
+    if (monte_carlo)
+    {
+        _logic = new MonteCarloLogic(_search_state, this); // searches on one thread
+    }
+    else
+    {
+        _logic = new SearchLogic(_search_state, this);
+        _logic->setThreadCount(QThread::idealThreadCount());
+    }
+    _monte_carlo = monte_carlo;
+}
+
+// PRIVATE
+
+// runs the logic on a copy of the position on the worker thread
+void MachinePlayer::startSearch(const Position &position)
+{
+    _search_state->setPosition(position);
+    _logic->clearCancel();
+    ++_search_count;
+
+    int search_id = _search_id;
+    _worker = std::thread([this, search_id]()
+    {
+        Move move = _logic->getMove();
+        // the move is sent to the thread of the player, the event is dropped if the player is deleted
+        QMetaObject::invokeMethod(this, [this, search_id, move]() {onMoveFound(search_id, move);}, Qt::QueuedConnection);
+    });
+}
+
+// sets the move of the last search and notifies the logic
+void MachinePlayer::onMoveFound(int search_id, Move move)
+{
+    if (search_id != _search_id) // cancelled
+    {
+        return;
+    }
+    if (_ponder_search) // kept until the expected position is reached
+    {
+        _ponder_move = move;
+        _has_ponder_move = true;
+        return;
+    }
+    state->move = move;
     state->passive_set = true;
     state->vector_set = true;
     emit moveMade();
 }
-
-void MachinePlayer::makeMove(Move) {} // machineplayer does not accept input
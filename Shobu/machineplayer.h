@@ -3,23 +3,53 @@
 
 #include <QObject>
 
+#include <thread>
+
+#include "position.h"
 #include "shobuplayer.h"
 
+class GameState;
 class MachineLogic;
-struct Move;
 
+// Searches on a worker thread, the move is set and moveMade is emitted on the thread of the player.
+// When pondering, it searches the expected position during the turn of the other player
 class MachinePlayer : public ShobuPlayer
 {
     Q_OBJECT
 public:
     MachinePlayer(MoveState *m_state, Color color, Difficulty difficulty, QObject *parent = nullptr);
+    ~MachinePlayer();
 
     void makeMove(int, int, int) override {makeMove();};
     void makeMove(Move) override;
     void makeMove() override;
+    void cancelMove() override;
+    void ponder() override;
+
+    void setPondering(bool pondering) {_pondering = pondering;}
+    bool getPondering() const {return _pondering;}
+    void setMonteCarlo(bool monte_carlo);
+    bool getMonteCarlo() const {return _monte_carlo;}
+    bool getExpectedMove(Move &move) const {move = _expected_move; return _ponder_search;} // false when not pondering
+    int getSearchCount() const {return _search_count;} // a ponder hit goes on with the ponder search
 
 private:
     MachineLogic *_logic;
+    Difficulty _difficulty;
+    bool _monte_carlo;
+    GameState *_search_state; // copy of the game for the logic, the game can change during the search
+    std::thread _worker;
+    int _search_id; // moves of earlier searches are dropped
+    int _search_count;
+
+    bool _pondering;
+    bool _ponder_search; // the search in progress is on the expected position and it was not reached yet
+    Move _expected_move; // of the other player, leads to the position of the ponder search
+    bool _has_ponder_move;
+    Move _ponder_move;   // found before the expected position was reached
+
+    void startSearch(const Position &position);
+    void onMoveFound(int search_id, Move move);
 };
 
 #endif // MACHINEPLAYER_H
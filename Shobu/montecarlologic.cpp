@@ -0,0 +1,260 @@
+#include "montecarlologic.h"
+
+#include <QScopedPointer>
+#include <QtMath>
+
+#include "shobuexception.h"
+#include "symmetry.h"
+
+enum MonteCarloValues
+{
+    TIME_BUDGET     =    1000, // default time of a move in milliseconds
+    MAX_NODES       = 1 << 21, // size limit of the arena, 32 megabytes
+    PLAYOUT_LENGTH  =       4, // plies of a playout before the position is evaluated, short ones guide better
+    EXPLORATION     =     141, // exploration constant of UCT in hundredths
+    PIECE_VALUE     =     100, // value of each piece in the evaluation of a playout
+    WEAKEST_VALUE   =      60, // extra value of each piece on the weakest board
+    EVALUATION_SPAN =    1600  // evaluation difference between a sure loss and a sure win
+};
+
+// PUBLIC
+
+// Constructor
+MonteCarloLogic::MonteCarloLogic(GameState *state, QObject *parent) : MachineLogic(state, parent),
+    _time_budget(TIME_BUDGET), _playout_budget(0), _random(QRandomGenerator::global()->generate()), _playouts(0) {}
+
+// grows the tree until a budget runs out, returns the most visited move of the root
+Move MonteCarloLogic::getMove()
+{
+    Position root = _state->getPosition();
+    if (!root.hasMoves()) // can not return a legal move when there are no legal moves
+    {
+        QScopedPointer<ShobuException> exept_ptr(new ShobuException());
+        exept_ptr->setMessage("No available moves to select from");
+        exept_ptr->raise();
+    }
+
+    reuseTree(root);
+    if (_nodes[0].child_count == 0) // a new root, symmetric children have the same value
+    {
+        MoveList moves;
+        Symmetry::getUniqueMoves(root, moves);
+        _nodes[0].first_child = static_cast<quint32>(_nodes.length());
+        _nodes[0].child_count = static_cast<quint16>(moves.length());
+        for (int i = 0; i < moves.length(); ++i)
+        {
+            _nodes.append(Node{moves[i], 0, 0, 0, 0.0f});
+        }
+    }
+
+    _timer.start();
+    _playouts = 0;
+
+    QVector<int> path;
+    while (_nodes[0].child_count > 1 && !outOfBudget())
+    {
+        // walk down the expanded nodes
+        Position position = root;
+        path.clear();
+        path.append(0);
+        int index = 0;
+        while (_nodes[index].child_count)
+        {
+            index = select(index);
+            position.applyUnchecked(_nodes[index].move);
+            path.append(index);
+        }
+
+        // a leaf is expanded on its second visit, one of its children is played out
+        if (_nodes[index].visits && position.getVictor() == EMPTY && position.hasMoves()
+            && _nodes.length() + MoveList::CAPACITY <= MAX_NODES)
+        {
+            expand(index, position);
+            index = _nodes[index].first_child;
+            position.applyUnchecked(_nodes[index].move);
+            path.append(index);
+        }
+
+        // the leaf gets the result of the player who moved into it, the players alternate upwards
+        float result = 1.0f - playout(position);
+        for (int i = path.length() - 1; i >= 0; --i)
+        {
+            Node &node = _nodes[path[i]];
+            ++node.visits;
+            node.wins += result;
+            result = 1.0f - result;
+        }
+        ++_playouts;
+    }
+
+    const Node &root_node = _nodes[0];
+    int best = root_node.first_child;
+    for (int i = best + 1; i < static_cast<int>(root_node.first_child + root_node.child_count); ++i)
+    {
+        if (_nodes[i].visits > _nodes[best].visits)
+        {
+            best = i;
+        }
+    }
+    return _nodes[best].move;
+}
+
+// PRIVATE
+
+// keeps the subtree of the position if it is the root or at most two plies below it, starts a new tree otherwise
+void MonteCarloLogic::reuseTree(const Position &position)
+{
+    if (!_nodes.isEmpty())
+    {
+        if (_root_position == position)
+        {
+            return;
+        }
+
+        const Node root = _nodes[0];
+        for (quint32 i = root.first_child; i < root.first_child + root.child_count; ++i)
+        {
+            Position child = _root_position;
+            child.applyUnchecked(_nodes[i].move);
+            if (child == position)
+            {
+                keepSubtree(i);
+                _root_position = position;
+                return;
+            }
+
+            const Node node = _nodes[i];
+            for (quint32 j = node.first_child; j < node.first_child + node.child_count; ++j)
+            {
+                Position grandchild = child;
+                grandchild.applyUnchecked(_nodes[j].move);
+                if (grandchild == position)
+                {
+                    keepSubtree(j);
+                    _root_position = position;
+                    return;
+                }
+            }
+        }
+    }
+
+    _nodes.clear();
+    _nodes.append(Node{PackedMove(0), 0, 0, 0, 0.0f});
+    _root_position = position;
+}
+
+// copies the subtree of the node into a new arena, breadth first so the children stay together
+void MonteCarloLogic::keepSubtree(int index)
+{
+    QVector<Node> kept;
+    kept.append(_nodes[index]);
+    for (int i = 0; i < kept.length(); ++i)
+    {
+        quint32 first = kept[i].first_child;
+        quint32 count = kept[i].child_count;
+        if (count)
+        {
+            kept[i].first_child = static_cast<quint32>(kept.length());
+            for (quint32 j = first; j < first + count; ++j)
+            {
+                kept.append(_nodes[j]);
+            }
+        }
+    }
+    _nodes.swap(kept);
+}
+
+// appends every child of the node to the arena
+void MonteCarloLogic::expand(int index, const Position &position)
+{
+    MoveList moves;
+    position.getMoves(moves);
+    _nodes[index].first_child = static_cast<quint32>(_nodes.length());
+    _nodes[index].child_count = static_cast<quint16>(moves.length());
+    for (int i = 0; i < moves.length(); ++i)
+    {
+        _nodes.append(Node{moves[i], 0, 0, 0, 0.0f});
+    }
+}
+
+// the first unvisited child, or the child with the best upper confidence bound
+int MonteCarloLogic::select(int index) const
+{
+    const Node &parent = _nodes[index];
+    float exploration = EXPLORATION / 100.0f * qSqrt(qLn(static_cast<float>(parent.visits)));
+
+    int best = -1;
+    float max = 0.0f;
+    for (int i = parent.first_child; i < static_cast<int>(parent.first_child + parent.child_count); ++i)
+    {
+        const Node &child = _nodes[i];
+        if (!child.visits)
+        {
+            return i;
+        }
+        float value = child.wins / child.visits + exploration / qSqrt(static_cast<float>(child.visits));
+        if (best < 0 || value > max)
+        {
+            best = i;
+            max = value;
+        }
+    }
+    return best;
+}
+
+// plays random moves, winning push offs when there are some, returns the result for the player to move
+float MonteCarloLogic::playout(Position &position)
+{
+    Color own = position.getTurn();
+    MoveList moves;
+    for (int ply = 0; ; ++ply)
+    {
+        if (Color victor = position.getVictor(); victor != EMPTY)
+        {
+            return victor == own ? 1.0f : 0.0f;
+        }
+        if (ply == PLAYOUT_LENGTH)
+        {
+            return evaluate(position, own);
+        }
+
+        position.getMoves(WINNING_PUSHES, moves);
+        if (moves.isEmpty())
+        {
+            position.getMoves(moves);
+            if (moves.isEmpty()) // a player without moves lost
+            {
+                return position.getTurn() == own ? 0.0f : 1.0f;
+            }
+        }
+        position.applyUnchecked(moves[_random.bounded(moves.length())]);
+    }
+}
+
+// checks the budgets and the cancel before each playout
+bool MonteCarloLogic::outOfBudget() const
+{
+    return isCancelled()
+           || (_playout_budget && _playouts >= _playout_budget)
+           || (_time_budget && _timer.elapsed() >= _time_budget);
+}
+
+// scores the pieces of both players for the color between 0 and 1, the weakest boards count more
+float MonteCarloLogic::evaluate(const Position &position, Color color)
+{
+    Color opponent = color == WHITE ? BLACK : WHITE;
+
+    int score = 0;
+    int own_min = 4;
+    int opponent_min = 4;
+    for (int i = 0; i < 4; ++i)
+    {
+        int own_count = position.getPieceCount(i, color);
+        int opponent_count = position.getPieceCount(i, opponent);
+        score += (own_count - opponent_count) * PIECE_VALUE;
+        own_min = qMin(own_min, own_count);
+        opponent_min = qMin(opponent_min, opponent_count);
+    }
+    score += (own_min - opponent_min) * WEAKEST_VALUE;
+    return 0.5f + qBound(-0.5f, static_cast<float>(score) / EVALUATION_SPAN, 0.5f);
+}
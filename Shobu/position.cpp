@@ -0,0 +1,1020 @@
+#include "position.h"
+
+#include <QScopedPointer>
+#include <QtAlgorithms>
+
+#include "shobuexception.h"
+
+// fields touched by a move of one piece, every mask is 0 where the move leaves the board
+struct Ray
+{
+    quint16 destination; // field the piece moves to
+    quint16 path;        // fields passed by the piece, including the destination
+    quint16 beyond;      // field a pushed piece lands on
+};
+
+struct RayTable
+{
+    Ray rays[16][8][2]; // indexed by field, direction and magnitude-1
+};
+
+// builds the rays of every field, direction and magnitude
+static constexpr RayTable generateRays()
+{
+    RayTable table{};
+    for (int field = 0; field < 16; ++field)
+    {
+        for (int direction = 0; direction < 8; ++direction)
+        {
+            int row_change = PackedMove::rowChange(direction);
+            int col_change = PackedMove::colChange(direction);
+            for (int magnitude = 1; magnitude <= 2; ++magnitude)
+            {
+                Ray &ray = table.rays[field][direction][magnitude-1];
+                for (int i = 1; i <= magnitude+1; ++i)
+                {
+                    int row = field/4 + row_change*i;
+                    int column = field%4 + col_change*i;
+                    if (row < 0 || row > 3 || column < 0 || column > 3) // the rest of the ray is off the board too
+                    {
+                        break;
+                    }
+
+                    quint16 bit = 1 << (row*4 + column);
+                    if (i <= magnitude)
+                    {
+                        ray.path |= bit;
+                    }
+                    if (i == magnitude)
+                    {
+                        ray.destination = bit;
+                    }
+                    if (i == magnitude+1)
+                    {
+                        ray.beyond = bit;
+                    }
+                }
+                if (!ray.destination) // a move leaving the board has no path
+                {
+                    ray.path = 0;
+                }
+            }
+        }
+    }
+    return table;
+}
+
+static constexpr RayTable RAYS = generateRays();
+
+// random keys of the Zobrist hash
+struct ZobristTable
+{
+    quint64 pieces[4][2][16]; // indexed by board, color and field
+    quint64 black_turn;       // added when black is to move
+};
+
+// fills the keys from a fixed seed with splitmix64, so every build hashes the same way
+static constexpr ZobristTable generateZobrist()
+{
+    ZobristTable table{};
+    quint64 seed = 0x5ED0B0A4D5C0FFEEULL;
+    auto next = [&seed]()
+    {
+        quint64 z = (seed += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    };
+
+    for (int board = 0; board < 4; ++board)
+    {
+        for (int color = 0; color < 2; ++color)
+        {
+            for (int field = 0; field < 16; ++field)
+            {
+                table.pieces[board][color][field] = next();
+            }
+        }
+    }
+    table.black_turn = next();
+    return table;
+}
+
+static constexpr ZobristTable ZOBRIST = generateZobrist();
+
+// MoveIndex
+
+// get passive pieces that are part of a legal move
+QVector<Coordinate> MoveIndex::getPassivePieces(int board_index) const
+{
+    QVector<Coordinate> ret;
+    if (board_index < 0 || board_index > 3)
+    {
+        return ret;
+    }
+
+    for (quint16 passives = _passives[board_index]; passives; passives &= passives - 1)
+    {
+        int field = qCountTrailingZeroBits(passives);
+        ret.push_back(Coordinate(board_index, field/4, field%4));
+    }
+    return ret;
+}
+
+// get passive destinations of passive piece that are part of a legal move
+QVector<Coordinate> MoveIndex::getDestinations(int board_index, Coordinate passive) const
+{
+    QVector<Coordinate> ret;
+    if (passive.board != board_index || board_index < 0 || board_index > 3 || passive.row < 0 || passive.row > 3 || passive.column < 0 || passive.column > 3)
+    {
+        return ret; // if passive is not on board, the destination can not be either
+    }
+
+    for (quint16 vectors = _vectors[board_index][passive.row*4 + passive.column]; vectors; vectors &= vectors - 1)
+    {
+        int vector = qCountTrailingZeroBits(vectors);
+        int magnitude = vector%2 + 1;
+        ret.push_back(Coordinate(board_index, passive.row + PackedMove::rowChange(vector/2)*magnitude, passive.column + PackedMove::colChange(vector/2)*magnitude));
+    }
+    return ret;
+}
+
+// get agressive pieces with given passive and vector that are part of a legal move
+QVector<Coordinate> MoveIndex::getAgressivePieces(int board_index, Coordinate passive, int row_change, int col_change, int magnitude) const
+{
+    QVector<Coordinate> ret;
+    if (passive.board % 2 == board_index % 2 || board_index < 0 || board_index > 3 || passive.board < 0 || passive.board > 3
+            || passive.row < 0 || passive.row > 3 || passive.column < 0 || passive.column > 3)
+    {
+        return ret; // if board is on the same side as the passive move, agressive is not possible
+    }
+    if ((magnitude != 1 && magnitude != 2) || row_change > 1 || row_change < -1 || col_change > 1 || col_change < -1 || (row_change == 0 && col_change == 0))
+    {
+        return ret; // not a move vector
+    }
+
+    int vector = toVector(PackedMove::toDirection(row_change, col_change), magnitude);
+    if (!(_vectors[passive.board][passive.row*4 + passive.column] & (1 << vector))) // passive piece can not make the move
+    {
+        return ret;
+    }
+
+    for (quint16 agressives = _agressives[board_index][vector]; agressives; agressives &= agressives - 1)
+    {
+        int field = qCountTrailingZeroBits(agressives);
+        ret.push_back(Coordinate(board_index, field/4, field%4));
+    }
+    return ret;
+}
+
+// PUBLIC
+
+// set up initial gamestate
+void Position::initializeGame()
+{
+    // Place pieces on first and last row on each board, everything else is empty
+    for (int i = 0; i < 4; ++i)
+    {
+        _pieces[i][BLACK] = 0x000F;
+        _pieces[i][WHITE] = 0xF000;
+    }
+    // White always starts the game
+    _turn = WHITE;
+
+    _hash = computeHash();
+}
+
+// returns the color of the piece on the given field
+Color Position::getField(int table, int row, int column) const
+{
+    quint16 field = 1 << toSquare(row, column);
+
+    if (_pieces[table][WHITE] & field)
+    {
+        return WHITE;
+    }
+    if (_pieces[table][BLACK] & field)
+    {
+        return BLACK;
+    }
+    return EMPTY;
+}
+
+// determines if board with the given index is homeboard of given color
+bool Position::isHomeBoard(Color color, int board_id)
+{
+    if (color == BLACK && board_id >=0 && board_id < 2)
+    {
+        return true;
+    }
+    if (color == WHITE && board_id >=2 && board_id < 4)
+    {
+        return true;
+    }
+    return false;
+}
+
+// Setters
+// field setter
+void Position::setField(int table, int row, int column, Color color)
+{
+    if (table < 0 || table > 3 || !onBoard(row, column))
+    {
+        QScopedPointer<ShobuException> exept_ptr(new ShobuException());
+        exept_ptr->setMessage("Field does not exist");
+        exept_ptr->raise();
+    }
+    quint16 field = 1 << toSquare(row, column);
+
+    // clear the field, then place the new piece if there is one
+    _hash ^= toggleKey(table, WHITE, _pieces[table][WHITE] & field) ^ toggleKey(table, BLACK, _pieces[table][BLACK] & field);
+    _pieces[table][WHITE] &= ~field;
+    _pieces[table][BLACK] &= ~field;
+    if (color != EMPTY)
+    {
+        _pieces[table][color] |= field;
+        _hash ^= toggleKey(table, color, field);
+    }
+}
+
+// turn setter
+void Position::setTurn(Color color)
+{
+    if (color == EMPTY)
+    {
+        QScopedPointer<ShobuException> exept_ptr(new ShobuException());
+        exept_ptr->setMessage("Turn has to be BLACK or WHITE");
+        exept_ptr->raise();
+    }
+    if (_turn != color)
+    {
+        _hash ^= ZOBRIST.black_turn;
+    }
+    _turn = color;
+}
+
+// Step functions
+// apply a move to the current board if it is legal
+void Position::makeMove(Move move)
+{
+    if (isLegalMove(move))
+    {
+        applyMove(move);
+    }
+}
+
+// give the turn to the next player
+void Position::endTurn()
+{
+    _turn = getOpponent(); // will be white if unitialized
+    _hash ^= ZOBRIST.black_turn;
+}
+
+// check if someone won the game on a board after a turn
+Color Position::getVictor() const
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        // if one color is completely gone from a board, game over
+        if (!_pieces[i][BLACK])
+        {
+            return WHITE;
+        }
+        if (!_pieces[i][WHITE])
+        {
+            return BLACK;
+        }
+    }
+    return EMPTY; // otherwise noone won yet
+}
+
+// Move checkers
+// checks if the player to move has any valid moves, stops at the first vector with a passive and an agressive piece
+bool Position::hasMoves() const
+{
+    return _turn == WHITE ? hasMovesFor<WHITE>() : hasMovesFor<BLACK>();
+}
+
+// hasMoves for the given side to move
+template<Color color>
+bool Position::hasMovesFor() const
+{
+    constexpr Color opponent = opponentOf<color>();
+    constexpr int home_id = homeId<color>();
+
+    for (int row_change = -1; row_change <= 1; ++row_change)
+    {
+        for (int col_change = -1; col_change <= 1; ++col_change)
+        {
+            if (col_change != 0 || row_change != 0) // only real moves
+            {
+                for (int magnitude = 1; magnitude <= 2; ++magnitude) // check all move vectors
+                {
+                    // boards with a piece that can use the current move vector as agressive
+                    bool agressive[4];
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        agressive[i] = _pieces[i][color] & getAgressives(_pieces[i][color], _pieces[i][opponent], row_change, col_change, magnitude);
+                    }
+
+                    // a passive piece on a homeboard needs an agressive piece on a board of the other side
+                    for (int p_board = home_id; p_board <= home_id+1; ++p_board)
+                    {
+                        if ((agressive[(p_board+1)%4] || agressive[(p_board+3)%4])
+                                && (_pieces[p_board][color] & getPassives(_pieces[p_board][color] | _pieces[p_board][opponent], row_change, col_change, magnitude)))
+                        {
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
+// checks all possible illegal moves
+bool Position::isLegalMove(Move move) const
+{
+    return isLegalPassive(move.p)
+           && isLegalVector(move.p, move.row_change, move.col_change, move.magnitude)
+           && isLegalAgressive(move);
+}
+
+// checks if passive piece is legal if nothing else is set
+bool Position::isLegalPassive(Coordinate coord) const
+{
+    return _turn == WHITE ? isLegalPassiveFor<WHITE>(coord) : isLegalPassiveFor<BLACK>(coord);
+}
+
+// isLegalPassive for the given side to move
+template<Color color>
+bool Position::isLegalPassiveFor(Coordinate coord) const
+{
+    // passive piece is on a legal field
+    if (coord.board < 0 || coord.board > 3 || !onBoard(coord.row, coord.column))
+    {
+        return false;
+    }
+
+    // player controls the passive field
+    if (!(_pieces[coord.board][color] & (1 << toSquare(coord.row, coord.column))))
+    {
+        return false;
+    }
+
+    // Passive field is on homeboard
+    if ((coord.board & 2) != (homeId<color>() & 2))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+// checks if vector is legal assuming passive piece is legal and agressive is not yet set
+bool Position::isLegalVector(Coordinate p, int row_change, int col_change, int magnitude) const
+{
+    // valid magnitude
+    if (magnitude != 1 && magnitude != 2)
+    {
+        return false;
+    }
+
+    // valid row_change
+    if (row_change > 1 || row_change < -1)
+    {
+        return false;
+    }
+
+    // valid col_change
+    if (col_change > 1 || col_change < -1)
+    {
+        return false;
+    }
+
+    // direction exists
+    if (col_change == 0 && row_change == 0)
+    {
+        return false;
+    }
+
+    // passive piece on the board
+    if (p.board < 0 || p.board > 3 || !onBoard(p.row, p.column))
+    {
+        return false;
+    }
+
+    // destination on the board and passive has no obstacles
+    const Ray &ray = RAYS.rays[toSquare(p.row, p.column)][PackedMove::toDirection(row_change, col_change)][magnitude-1];
+    return ray.destination && !(ray.path & (_pieces[p.board][WHITE] | _pieces[p.board][BLACK]));
+}
+
+// checks if agressive piece is legal assuming passive piece and vector are legal
+bool Position::isLegalAgressive(Move move) const
+{
+    // Selected fields are on legal boards
+    // passive piece is on homeboard, agressive is on opposite board
+    if (move.p.board%2 == move.a.board%2)
+    {
+        return false;
+    }
+
+    // agressive piece is on a legal field
+    if (move.a.board < 0 || move.a.board > 3 || !onBoard(move.a.row, move.a.column))
+    {
+        return false;
+    }
+
+    // player controls the agressive field
+    if (getField(move.a.board, move.a.row, move.a.column) != _turn)
+    {
+        return false;
+    }
+
+    // if board is correct, return if move is valid on the board
+    return isLegalAgressive(move.a, move.row_change, move.col_change, move.magnitude);
+}
+
+// checks if agressive piece is legal assuming passive piece and vector are legal
+bool Position::isLegalAgressive(Coordinate a, int row_change, int col_change, int magnitude) const
+{
+    // agressive piece is on a legal field
+    if (a.board < 0 || a.board > 3 || !onBoard(a.row, a.column))
+    {
+        return false;
+    }
+
+    // vector has to be valid for the lookups
+    if ((magnitude != 1 && magnitude != 2) || row_change > 1 || row_change < -1 || col_change > 1 || col_change < -1 || (row_change == 0 && col_change == 0))
+    {
+        return false;
+    }
+
+    const Ray &ray = RAYS.rays[toSquare(a.row, a.column)][PackedMove::toDirection(row_change, col_change)][magnitude-1];
+    quint16 own = _pieces[a.board][_turn];
+    quint16 opponent = _pieces[a.board][getOpponent()];
+    quint16 pushed = ray.path & opponent;
+
+    // destination on the board, can not push own piece, at most one opposing piece can be on the way
+    if (!ray.destination || (ray.path & own) || (pushed & (pushed - 1)))
+    {
+        return false;
+    }
+
+    // the pushed piece either leaves the board or lands on an empty field
+    return !pushed || !(ray.beyond & (own | opponent));
+}
+
+// gets all possible moves of the given color into the given list
+void Position::getMoves(Color color, MoveList &moves) const
+{
+    moves.clear();
+
+    // only BLACK or WHITE has moves
+    if (color == WHITE)
+    {
+        getMovesFor<WHITE>(moves);
+    }
+    else if (color == BLACK)
+    {
+        getMovesFor<BLACK>(moves);
+    }
+}
+
+// gets the moves of one stage for the player to move, the stages together give the moves of getMoves
+void Position::getMoves(MoveStage stage, MoveList &moves) const
+{
+    switch (stage)
+    {
+    case WINNING_PUSHES:
+        getSelectedMoves(WINNING_PUSH_OFF, moves);
+        break;
+    case PUSHES:
+        getSelectedMoves(PUSH_OFF | PUSH_ON_BOARD, moves);
+        break;
+    default:
+        getSelectedMoves(QUIET, moves);
+        break;
+    }
+}
+
+// gets the moves of the player to move that push an opposing piece
+void Position::getPushes(MoveList &moves) const
+{
+    getSelectedMoves(WINNING_PUSH_OFF | PUSH_OFF | PUSH_ON_BOARD, moves);
+}
+
+// gets the moves of the player to move that push an opposing piece off its board
+void Position::getPushOffs(MoveList &moves) const
+{
+    getSelectedMoves(WINNING_PUSH_OFF | PUSH_OFF, moves);
+}
+
+// gets the moves of the player to move with the given kinds of agressive parts
+void Position::getSelectedMoves(int kinds, MoveList &moves) const
+{
+    moves.clear();
+
+    if (_turn == WHITE)
+    {
+        getSelectedFor<WHITE>(kinds, moves);
+    }
+    else
+    {
+        getSelectedFor<BLACK>(kinds, moves);
+    }
+}
+
+// gets all possible moves of the given color
+QVector<Move> Position::getMoves(Color color) const
+{
+    MoveList moves;
+    getMoves(color, moves);
+
+    QVector<Move> ret; // return vector
+    ret.reserve(moves.length());
+    for (PackedMove move : moves)
+    {
+        ret.push_back(move);
+    }
+    return ret;
+}
+
+// get passive pieces that are part of a legal move
+QVector<Coordinate> Position::getPassivePieces(int board_index) const
+{
+    return getMoveIndex().getPassivePieces(board_index);
+}
+
+// get passive destinations of passive piece that are part of a legal move
+QVector<Coordinate> Position::getDestinations(int board_index, Coordinate passive) const
+{
+    return getMoveIndex().getDestinations(board_index, passive);
+}
+
+// get agressive pieces with given passive and vector that are part of a legal move
+QVector<Coordinate> Position::getAgressivePieces(int board_index, Coordinate passive, int row_change, int col_change, int magnitude) const
+{
+    return getMoveIndex().getAgressivePieces(board_index, passive, row_change, col_change, magnitude);
+}
+
+// collects the passive pieces, their vectors and the agressive pieces of every vector, even for redundant moves
+MoveIndex Position::getMoveIndex() const
+{
+    MoveIndex index{};
+    Color color = getTurn();
+    Color opponent = getOpponent();
+    int home_id = color == WHITE ? 2 : 0;
+
+    for (int direction = 0; direction < 8; ++direction)
+    {
+        int row_change = PackedMove::rowChange(direction);
+        int col_change = PackedMove::colChange(direction);
+        for (int magnitude = 1; magnitude <= 2; ++magnitude) // check all move vectors
+        {
+            int vector = MoveIndex::toVector(direction, magnitude);
+
+            // get pieces that can use the current move vector as agressive on every board
+            for (int i = 0; i < 4; ++i)
+            {
+                index._agressives[i][vector] = _pieces[i][color] & getAgressives(_pieces[i][color], _pieces[i][opponent], row_change, col_change, magnitude);
+            }
+
+            // passive pieces on homeboards need an agressive piece on a board of the other side
+            for (int p_board = home_id; p_board <= home_id+1; ++p_board)
+            {
+                if (!index._agressives[(p_board+1)%4][vector] && !index._agressives[(p_board+3)%4][vector])
+                {
+                    continue;
+                }
+
+                quint16 passives = _pieces[p_board][color] & getPassives(_pieces[p_board][color] | _pieces[p_board][opponent], row_change, col_change, magnitude);
+                index._passives[p_board] |= passives;
+                for (; passives; passives &= passives - 1)
+                {
+                    index._vectors[p_board][qCountTrailingZeroBits(passives)] |= 1 << vector;
+                }
+            }
+        }
+    }
+    return index;
+}
+
+// returns a copy of the position with a move applied to it
+Position Position::getApplied(Move move) const
+{
+    Position ret = *this;
+    ret.applyMove(move);
+
+    return ret;
+}
+
+// apply a move to the current board, return reverse data
+ReverseData Position::applyMove(Move move)
+{
+    // illegal moves throw an exception
+    if (!isLegalMove(move))
+    {
+        QScopedPointer<ShobuException> exept_ptr(new ShobuException());
+        exept_ptr->setMessage("Illegal move");
+        exept_ptr->raise();
+    }
+
+    return applyUnchecked(PackedMove(move));
+}
+
+// reverse a previous move based on given data
+void Position::reverseMove(Move move, ReverseData data)
+{
+    reverseUnchecked(PackedMove(move), data);
+}
+
+// apply a move from the step finder functions without checking it, return reverse data
+ReverseData Position::applyUnchecked(PackedMove move)
+{
+    Q_ASSERT(isLegalMove(move));
+
+    Color opponent = getOpponent();
+    int p_board = move.passiveBoard();
+    int a_board = move.agressiveBoard();
+    const Ray &passive = RAYS.rays[move.passiveField()][move.direction()][move.magnitude()-1];
+    const Ray &agressive = RAYS.rays[move.agressiveField()][move.direction()][move.magnitude()-1];
+
+    // Passive move
+    quint16 p_toggle = (1 << move.passiveField()) | passive.destination;
+    _pieces[p_board][_turn] ^= p_toggle;
+    _hash ^= toggleKey(p_board, _turn, p_toggle);
+
+    ReverseData reverse;
+    reverse.has_push = false;
+    reverse.on_board = false;
+
+    // Agressive move
+    //push opposing piece
+    if (quint16 pushed = agressive.path & _pieces[a_board][opponent]; pushed)
+    {
+        int from = qCountTrailingZeroBits(pushed);
+        reverse.has_push = true;
+        reverse.pushed_from = Coordinate(a_board, from/4, from%4);
+        _pieces[a_board][opponent] ^= pushed;
+        _hash ^= toggleKey(a_board, opponent, pushed);
+
+        // if piece was pushed to board, place it back
+        if (agressive.beyond)
+        {
+            int to = qCountTrailingZeroBits(agressive.beyond);
+            _pieces[a_board][opponent] |= agressive.beyond;
+            _hash ^= toggleKey(a_board, opponent, agressive.beyond);
+
+            reverse.on_board = true;
+            reverse.pushed_to = Coordinate(a_board, to/4, to%4);
+        }
+    }
+
+    // place own piece
+    quint16 a_toggle = (1 << move.agressiveField()) | agressive.destination;
+    _pieces[a_board][_turn] ^= a_toggle;
+    _hash ^= toggleKey(a_board, _turn, a_toggle);
+
+    endTurn();
+    return reverse;
+}
+
+// reverse a move applied by applyUnchecked based on given data
+void Position::reverseUnchecked(PackedMove move, ReverseData data)
+{
+    endTurn(); // get back the original color as turn
+
+    const Ray &passive = RAYS.rays[move.passiveField()][move.direction()][move.magnitude()-1];
+    const Ray &agressive = RAYS.rays[move.agressiveField()][move.direction()][move.magnitude()-1];
+
+    // reset passives
+    quint16 p_toggle = (1 << move.passiveField()) | passive.destination;
+    _pieces[move.passiveBoard()][_turn] ^= p_toggle;
+    _hash ^= toggleKey(move.passiveBoard(), _turn, p_toggle);
+
+    // reset agressives
+    quint16 a_toggle = (1 << move.agressiveField()) | agressive.destination;
+    _pieces[move.agressiveBoard()][_turn] ^= a_toggle;
+    _hash ^= toggleKey(move.agressiveBoard(), _turn, a_toggle);
+
+    // reset pushed
+    if (data.has_push)
+    {
+        quint16 from = 1 << toSquare(data.pushed_from.row, data.pushed_from.column);
+        _pieces[data.pushed_from.board][getOpponent()] |= from;
+        _hash ^= toggleKey(data.pushed_from.board, getOpponent(), from);
+        if (data.on_board)
+        {
+            quint16 to = 1 << toSquare(data.pushed_to.row, data.pushed_to.column);
+            _pieces[data.pushed_to.board][getOpponent()] &= ~to;
+            _hash ^= toggleKey(data.pushed_to.board, getOpponent(), to);
+        }
+    }
+}
+
+// StagedMoves
+
+// gives the next move, generates the next stage when the current one ran out
+bool StagedMoves::next(PackedMove &move)
+{
+    while (_index == _moves.length())
+    {
+        if (++_stage == STAGE_COUNT)
+        {
+            _stage = STAGE_COUNT - 1; // stay on the last stage with an empty list
+            return false;
+        }
+        _position.getMoves(static_cast<MoveStage>(_stage), _moves);
+        _index = 0;
+    }
+    move = _moves[_index++];
+    return true;
+}
+
+// positions are equal if they have the same pieces and turn
+bool Position::operator==(const Position &other) const
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        if (_pieces[i][WHITE] != other._pieces[i][WHITE] || _pieces[i][BLACK] != other._pieces[i][BLACK])
+        {
+            return false;
+        }
+    }
+    return _turn == other._turn;
+}
+
+// PRIVATE
+
+// checks if the given coordinates can be on a board
+bool Position::onBoard(int x, int y)
+{
+    return 0 <= x && x < 4 && 0 <= y && y < 4;
+}
+
+// returns the combined Zobrist key of the fields in the mask
+quint64 Position::toggleKey(int board_id, int color, quint16 mask)
+{
+    quint64 key = 0;
+    for (; mask; mask &= mask - 1)
+    {
+        key ^= ZOBRIST.pieces[board_id][color][qCountTrailingZeroBits(mask)];
+    }
+    return key;
+}
+
+// computes the Zobrist key of the whole position
+quint64 Position::computeHash() const
+{
+    quint64 key = _turn == BLACK ? ZOBRIST.black_turn : 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        key ^= toggleKey(i, WHITE, _pieces[i][WHITE]) ^ toggleKey(i, BLACK, _pieces[i][BLACK]);
+    }
+    return key;
+}
+
+// returns the fields from which the field at the given distance in the given direction is in the mask
+quint16 Position::lookAhead(quint16 mask, int row_change, int col_change, int distance)
+{
+    // fields from which the target is still on the board
+    quint16 rows = 0xFFFF;
+    quint16 columns = 0xFFFF;
+    if (row_change > 0)
+    {
+        rows = 0xFFFF >> (4*distance);
+    }
+    else if (row_change < 0)
+    {
+        rows = 0xFFFF << (4*distance);
+    }
+    if (col_change > 0)
+    {
+        columns = (0x1111 << (4-distance)) - 0x1111; // columns 0 .. 3-distance
+    }
+    else if (col_change < 0)
+    {
+        columns = 0xFFFF - ((0x1111 << distance) - 0x1111); // columns distance .. 3
+    }
+
+    // shift the target fields back onto their sources
+    int offset = (row_change*4 + col_change) * distance;
+    quint16 sources = offset > 0 ? mask >> offset : mask << -offset;
+
+    return sources & rows & columns;
+}
+
+// Step finder functions
+// get fields that can make the given move as passive
+quint16 Position::getPassives(quint16 occupied, int row_change, int col_change, int magnitude)
+{
+    // every field on the way must be empty
+    quint16 ret = lookAhead(~occupied, row_change, col_change, 1);
+    if (magnitude == 2)
+    {
+        ret &= lookAhead(~occupied, row_change, col_change, 2);
+    }
+    return ret;
+}
+
+// get fields that can make the given move as agressive (or passive)
+quint16 Position::getAgressives(quint16 own, quint16 opponent, int row_change, int col_change, int magnitude)
+{
+    quint16 occupied = own | opponent;
+
+    // can not push own piece, at most one opposing piece can be on the way
+    quint16 ret = lookAhead(~own, row_change, col_change, 1);
+    quint16 pushes = lookAhead(opponent, row_change, col_change, 1);
+    if (magnitude == 2)
+    {
+        quint16 second_push = lookAhead(opponent, row_change, col_change, 2);
+        ret &= lookAhead(~own, row_change, col_change, 2) & ~(pushes & second_push);
+        pushes |= second_push;
+    }
+
+    // the pushed piece either leaves the board or lands on an empty field
+    return ret & ~(pushes & lookAhead(occupied, row_change, col_change, magnitude+1));
+}
+
+// add every combination of the given passive and agressive fields as a move
+void Position::addMoves(MoveList &moves, int p_board, quint16 passives, int a_board, quint16 agressives, int direction, int magnitude)
+{
+    for (quint16 p = passives; p; p &= p - 1) // visit set bits from the lowest
+    {
+        int i = qCountTrailingZeroBits(p);
+        for (quint16 a = agressives; a; a &= a - 1) // add all possible combinations
+        {
+            moves.append(PackedMove(p_board, i, a_board, qCountTrailingZeroBits(a), direction, magnitude));
+        }
+    }
+}
+
+// gets the moves of getMoves for the given side
+template<Color color>
+void Position::getMovesFor(MoveList &moves) const
+{
+    // homeboards of the side
+    constexpr int home_id = homeId<color>();
+    constexpr int opponent_id = homeId<opponentOf<color>()>();
+
+    // add moves from board pairs
+    getMovesFromBoards<color>(home_id,   opponent_id+1, moves);
+    getMovesFromBoards<color>(home_id+1, opponent_id,   moves);
+
+    // agressives pushing, non pushing are already included as passives
+    getAgressiveMovesFromBoards<color>(home_id+1, home_id, moves);
+
+    getMovesFromBoards<color>(home_id, home_id+1, moves);
+}
+
+// gets the moves of getSelectedMoves for the given side
+template<Color color>
+void Position::getSelectedFor(int kinds, MoveList &moves) const
+{
+    constexpr int home_id = homeId<color>();
+    constexpr int opponent_id = homeId<opponentOf<color>()>();
+
+    // same board pairs as getMoves, agressives on the homeboard are only pushing for the second homeboard
+    getSelectedFromBoards<color>(home_id,   opponent_id+1, kinds, false, moves);
+    getSelectedFromBoards<color>(home_id+1, opponent_id,   kinds, false, moves);
+    getSelectedFromBoards<color>(home_id+1, home_id,       kinds, true,  moves);
+    getSelectedFromBoards<color>(home_id,   home_id+1,     kinds, false, moves);
+}
+
+// get all legal moves from the two boards assuming boards are legal
+template<Color color>
+void Position::getMovesFromBoards(int p_board, int a_board, MoveList &moves) const
+{
+    constexpr Color opponent = opponentOf<color>();
+    quint16 p_own = _pieces[p_board][color];
+    quint16 a_own = _pieces[a_board][color];
+    quint16 a_opponent = _pieces[a_board][opponent];
+
+    if (!p_own || !a_own) // no moves without pieces
+    {
+        return;
+    }
+
+    for (int row_change = -1; row_change <= 1; ++row_change)
+    {
+        for (int col_change = -1; col_change <= 1; ++col_change)
+        {
+            if (col_change != 0 || row_change != 0) // only real moves
+            {
+                for (int magnitude = 1; magnitude <= 2; ++magnitude) // check all move vectors
+                {
+                    // get pieces that can use the current move vector as passive
+                    quint16 passives = p_own & getPassives(p_own | _pieces[p_board][opponent], row_change, col_change, magnitude);
+
+                    // get pieces that can use the current move vector as agressive
+                    quint16 agressives = a_own & getAgressives(a_own, a_opponent, row_change, col_change, magnitude);
+
+                    addMoves(moves, p_board, passives, a_board, agressives, PackedMove::toDirection(row_change, col_change), magnitude);
+                }
+            }
+        }
+    }
+}
+
+// get all legal agressive moves from the two boards that are not passive assuming boards are legal
+template<Color color>
+void Position::getAgressiveMovesFromBoards(int p_board, int a_board, MoveList &moves) const
+{
+    constexpr Color opponent = opponentOf<color>();
+    quint16 p_own = _pieces[p_board][color];
+    quint16 a_own = _pieces[a_board][color];
+    quint16 a_opponent = _pieces[a_board][opponent];
+
+    if (!p_own || !a_own) // no moves without pieces
+    {
+        return;
+    }
+
+    for (int row_change = -1; row_change <= 1; ++row_change)
+    {
+        for (int col_change = -1; col_change <= 1; ++col_change)
+        {
+            if (col_change != 0 || row_change != 0) // only real moves
+            {
+                for (int magnitude = 1; magnitude <= 2; ++magnitude) // check all move vectors
+                {
+                    // get pieces that can use the current move vector as passive
+                    quint16 passives = p_own & getPassives(p_own | _pieces[p_board][opponent], row_change, col_change, magnitude);
+
+                    // get pieces that can use the current move vector as agressive, but not as passive
+                    quint16 agressives = a_own & getAgressives(a_own, a_opponent, row_change, col_change, magnitude)
+                                         & ~getPassives(a_own | a_opponent, row_change, col_change, magnitude);
+
+                    addMoves(moves, p_board, passives, a_board, agressives, PackedMove::toDirection(row_change, col_change), magnitude);
+                }
+            }
+        }
+    }
+}
+
+// get the moves of the given kinds from the two boards assuming boards are legal
+template<Color color>
+void Position::getSelectedFromBoards(int p_board, int a_board, int kinds, bool pushes_only, MoveList &moves) const
+{
+    constexpr Color opponent = opponentOf<color>();
+    quint16 p_own = _pieces[p_board][color];
+    quint16 a_own = _pieces[a_board][color];
+    quint16 a_opponent = _pieces[a_board][opponent];
+
+    if (pushes_only)
+    {
+        kinds &= ~QUIET;
+    }
+    if (!p_own || !a_own || !kinds) // no moves without pieces
+    {
+        return;
+    }
+    bool last_piece = qPopulationCount(a_opponent) == 1; // pushing it off wins the game
+
+    for (int row_change = -1; row_change <= 1; ++row_change)
+    {
+        for (int col_change = -1; col_change <= 1; ++col_change)
+        {
+            if (col_change != 0 || row_change != 0) // only real moves
+            {
+                for (int magnitude = 1; magnitude <= 2; ++magnitude) // check all move vectors
+                {
+                    // pieces with an opposing piece on the way, and pieces that push it off the board
+                    quint16 pushes = lookAhead(a_opponent, row_change, col_change, 1);
+                    if (magnitude == 2)
+                    {
+                        pushes |= lookAhead(a_opponent, row_change, col_change, 2);
+                    }
+                    quint16 push_offs = ~lookAhead(0xFFFF, row_change, col_change, magnitude+1);
+
+                    quint16 selected = 0;
+                    if (kinds & (last_piece ? WINNING_PUSH_OFF : PUSH_OFF))
+                    {
+                        selected |= pushes & push_offs;
+                    }
+                    if (kinds & PUSH_ON_BOARD)
+                    {
+                        selected |= pushes & ~push_offs;
+                    }
+                    if (kinds & QUIET)
+                    {
+                        selected |= ~pushes;
+                    }
+
+                    quint16 agressives = a_own & selected & getAgressives(a_own, a_opponent, row_change, col_change, magnitude);
+                    if (!agressives)
+                    {
+                        continue;
+                    }
+
+                    // get pieces that can use the current move vector as passive
+                    quint16 passives = p_own & getPassives(p_own | _pieces[p_board][opponent], row_change, col_change, magnitude);
+
+                    addMoves(moves, p_board, passives, a_board, agressives, PackedMove::toDirection(row_change, col_change), magnitude);
+                }
+            }
+        }
+    }
+}
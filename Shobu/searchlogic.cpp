@@ -0,0 +1,316 @@
+#include "searchlogic.h"
+
+#include <QScopedPointer>
+
+#include <thread>
+#include <vector>
+
+#include "shobuexception.h"
+#include "symmetry.h"
+
+enum SearchValues
+{
+    TIME_BUDGET    =    1000, // default time of a move in milliseconds
+    MAX_DEPTH      =      64, // deepest iteration
+    CHECK_INTERVAL =    1023, // nodes between two looks at the clock, plus one
+    INFINITE_SCORE = 1000000, // bounds of the first window; no score can exceed this
+    VICTORY        =  100000, // score of a won position, minus the plies to reach it
+    PIECE_VALUE    =     100, // value of each piece
+    WEAKEST_VALUE  =      60  // extra value of each piece on the weakest board
+};
+
+// PUBLIC
+
+// Constructor
+SearchLogic::SearchLogic(GameState *state, QObject *parent) : MachineLogic(state, parent),
+    _time_budget(TIME_BUDGET), _node_budget(0), _nodes(0), _stopped(false), _completed_depth(0) {}
+
+// searches deeper until a budget runs out, returns the best move of the last completed iteration
+Move SearchLogic::getMove()
+{
+    Worker main;
+    main.position = _state->getPosition(); // search on a copy, the game is not touched
+    Symmetry::getUniqueMoves(main.position, main.moves); // symmetric children have the same score
+    main.nodes = 0;
+    main.completed_depth = 0;
+    main.partial_best = -1;
+
+    if (main.moves.isEmpty()) // can not return a legal move when there are no legal moves
+    {
+        QScopedPointer<ShobuException> exept_ptr(new ShobuException());
+        exept_ptr->setMessage("No available moves to select from");
+        exept_ptr->raise();
+    }
+
+    _table.newSearch();
+    _timer.start();
+    _nodes = 0;
+    _stopped = false;
+
+    // every helper starts from its own copy, every other one a ply deeper to spread the work
+    QVector<Worker> helpers(_thread_count - 1, main);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < helpers.length(); ++i)
+    {
+        threads.emplace_back(&SearchLogic::iterate, this, std::ref(helpers[i]), 1 + (i+1) % 2);
+    }
+
+    iterate(main, 1);
+    _stopped = true; // the helpers stop with the first thread
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    _completed_depth = main.completed_depth;
+
+    if (main.completed_depth == 0 && main.partial_best >= 0)
+    {
+        return main.moves[main.partial_best];
+    }
+    return main.moves[0];
+}
+
+// the expected move is the stored best move of the position, the table keeps it from the last search
+bool SearchLogic::getPonderMove(const Position &position, PackedMove &move) const
+{
+    TranspositionEntry entry;
+    if (_table.probe(position.hash(), entry) && entry.move.toInt() && position.isLegalMove(entry.move)) // keys can collide
+    {
+        move = entry.move;
+        return true;
+    }
+    return false;
+}
+
+// PRIVATE
+
+// deepens the search of one thread until a budget runs out or the result is proven
+void SearchLogic::iterate(Worker &worker, int first_depth)
+{
+    worker.nodes = 0;
+    worker.completed_depth = 0;
+    worker.partial_best = -1;
+
+    MoveList &moves = worker.moves;
+    for (int depth = first_depth; depth <= MAX_DEPTH; ++depth)
+    {
+        int alpha = -INFINITE_SCORE;
+        int best = -1;
+        for (int i = 0; i < moves.length(); ++i)
+        {
+            // the best move of the previous iteration is searched first with a full window, the rest with a null window
+            ReverseData reverse = worker.position.applyUnchecked(moves[i]);
+            int score;
+            if (i == 0)
+            {
+                score = -search(worker, depth - 1, 1, -INFINITE_SCORE, -alpha);
+            }
+            else
+            {
+                score = -search(worker, depth - 1, 1, -alpha - 1, -alpha);
+                if (score > alpha && !isStopped())
+                {
+                    score = -search(worker, depth - 1, 1, -INFINITE_SCORE, -alpha);
+                }
+            }
+            worker.position.reverseUnchecked(moves[i], reverse);
+
+            if (isStopped())
+            {
+                break;
+            }
+            if (score > alpha)
+            {
+                alpha = score;
+                best = i;
+            }
+        }
+
+        if (isStopped())
+        {
+            if (worker.completed_depth == 0)
+            {
+                worker.partial_best = best;
+            }
+            break;
+        }
+
+        // the best move leads the next iteration, the others keep their order
+        PackedMove best_move = moves[best];
+        for (int i = best; i > 0; --i)
+        {
+            moves[i] = moves[i-1];
+        }
+        moves[0] = best_move;
+        worker.completed_depth = depth;
+
+        if (alpha >= VICTORY - MAX_DEPTH || alpha <= -VICTORY + MAX_DEPTH) // the result is proven, deeper search does not change it
+        {
+            break;
+        }
+    }
+    _nodes += worker.nodes;
+    worker.nodes = 0;
+}
+
+// negamax principal variation search, the score is from the view of the player to move
+int SearchLogic::search(Worker &worker, int depth, int ply, int alpha, int beta)
+{
+    if (outOfBudget(worker)) // the score is dropped together with the iteration
+    {
+        return 0;
+    }
+    ++worker.nodes;
+
+    Position &position = worker.position;
+
+    if (Color victor = position.getVictor(); victor != EMPTY) // faster victories are better
+    {
+        return victor == position.getTurn() ? VICTORY - ply : -VICTORY + ply;
+    }
+    if (!position.hasMoves()) // a player without moves lost
+    {
+        return -VICTORY + ply;
+    }
+    if (depth <= 0)
+    {
+        return evaluate(position);
+    }
+
+    // a stored result may end the search here, its move is searched first otherwise
+    TranspositionEntry entry;
+    PackedMove hash_move(0);
+    if (_table.probe(position.hash(), entry))
+    {
+        int score = fromTable(entry.score, ply);
+        if (entry.depth >= depth && (entry.bound == EXACT_BOUND
+                                     || (entry.bound == LOWER_BOUND && score >= beta)
+                                     || (entry.bound == UPPER_BOUND && score <= alpha)))
+        {
+            return score;
+        }
+        if (entry.move.toInt() && position.isLegalMove(entry.move)) // keys can collide
+        {
+            hash_move = entry.move;
+        }
+    }
+
+    int original_alpha = alpha;
+    PackedMove best_move(0);
+    StagedMoves moves(position); // pushes first, quiet moves are only generated if there is no cut before them
+    PackedMove move = hash_move;
+    bool first = true;
+    while ((first && hash_move.toInt()) || moves.next(move))
+    {
+        if (!first && move == hash_move) // already searched
+        {
+            continue;
+        }
+        ReverseData reverse = position.applyUnchecked(move);
+        int score;
+        if (first)
+        {
+            score = -search(worker, depth - 1, ply + 1, -beta, -alpha);
+        }
+        else
+        {
+            // later moves only have to be proven worse, search them again if they are not
+            score = -search(worker, depth - 1, ply + 1, -alpha - 1, -alpha);
+            if (score > alpha && score < beta && !isStopped())
+            {
+                score = -search(worker, depth - 1, ply + 1, -beta, -alpha);
+            }
+        }
+        position.reverseUnchecked(move, reverse);
+
+        if (isStopped())
+        {
+            return 0;
+        }
+        first = false;
+        if (score > alpha)
+        {
+            alpha = score;
+            best_move = move;
+            if (alpha >= beta)
+            {
+                break;
+            }
+        }
+    }
+
+    Bound bound = alpha >= beta ? LOWER_BOUND : (alpha > original_alpha ? EXACT_BOUND : UPPER_BOUND);
+    _table.store(position.hash(), depth, bound, toTable(alpha, ply), best_move.toInt() ? best_move : hash_move);
+    return alpha;
+}
+
+// victory scores are stored as plies from the stored position, not from the root
+int SearchLogic::toTable(int score, int ply)
+{
+    if (score >= VICTORY - MAX_DEPTH)
+    {
+        return score + ply;
+    }
+    if (score <= -VICTORY + MAX_DEPTH)
+    {
+        return score - ply;
+    }
+    return score;
+}
+
+// converts a stored victory score back to plies from the root
+int SearchLogic::fromTable(int score, int ply)
+{
+    if (score >= VICTORY - MAX_DEPTH)
+    {
+        return score - ply;
+    }
+    if (score <= -VICTORY + MAX_DEPTH)
+    {
+        return score + ply;
+    }
+    return score;
+}
+
+// checks the budgets, adds the nodes of the worker to the total and looks at the clock and the cancel every CHECK_INTERVAL+1 nodes
+bool SearchLogic::outOfBudget(Worker &worker)
+{
+    if (isStopped())
+    {
+        return true;
+    }
+    if (_node_budget && !isPondering() && _nodes.load(std::memory_order_relaxed) + worker.nodes >= _node_budget)
+    {
+        _stopped = true;
+    }
+    else if ((worker.nodes & CHECK_INTERVAL) == 0)
+    {
+        _nodes += worker.nodes;
+        worker.nodes = 0;
+        if ((_time_budget && !isPondering() && _timer.elapsed() >= _time_budget) || isCancelled())
+        {
+            _stopped = true;
+        }
+    }
+    return isStopped();
+}
+
+// scores the pieces of both players from the view of the player to move, the weakest boards count more
+int SearchLogic::evaluate(const Position &position)
+{
+    Color own = position.getTurn();
+    Color opponent = position.getOpponent();
+
+    int score = 0;
+    int own_min = 4;
+    int opponent_min = 4;
+    for (int i = 0; i < 4; ++i)
+    {
+        int own_count = position.getPieceCount(i, own);
+        int opponent_count = position.getPieceCount(i, opponent);
+        score += (own_count - opponent_count) * PIECE_VALUE;
+        own_min = qMin(own_min, own_count);
+        opponent_min = qMin(opponent_min, opponent_count);
+    }
+    return score + (own_min - opponent_min) * WEAKEST_VALUE;
+}
@@ -0,0 +1,68 @@
+#ifndef SEARCHLOGIC_H
+#define SEARCHLOGIC_H
+
+#include <QElapsedTimer>
+
+#include <atomic>
+
+#include "machinelogic.h"
+#include "transpositiontable.h"
+
+// Iterative deepening principal variation search, stops when the time or the node budget is used up.
+// With more threads, helpers run the same search on their own copies and share the table (Lazy SMP),
+// the first thread gives the move and each helper can pass the node budget by CHECK_INTERVAL nodes.
+// While pondering the budgets are ignored, the time budget is counted from the start of the search
+class SearchLogic : public MachineLogic
+{
+    Q_OBJECT
+public:
+    SearchLogic(GameState *state, QObject *parent = nullptr);
+
+    Move getMove() override;
+    bool getPonderMove(const Position &position, PackedMove &move) const override;
+
+    // Budgets
+    void setTimeBudget(int msec) {_time_budget = msec;}     // 0 means no time limit
+    void setNodeBudget(quint64 nodes) {_node_budget = nodes;} // 0 means no node limit
+    int getTimeBudget() const {return _time_budget;}
+    quint64 getNodeBudget() const {return _node_budget;}
+
+    // the table is kept between the moves, resizing clears it
+    void setTableSize(int megabytes) {_table.resize(megabytes);}
+    int getTableSize() const {return _table.getSize();}
+
+    // results of the last getMove
+    int getCompletedDepth() const {return _completed_depth;}
+    quint64 getNodeCount() const {return _nodes.load();} // of every thread
+
+private:
+    // search state of one thread
+    struct Worker
+    {
+        Position position; // private copy of the root position
+        MoveList moves;    // root moves, the best of the last iteration first
+        quint64 nodes;     // not yet added to _nodes
+        int completed_depth;
+        int partial_best;  // best move of the first iteration if even that one did not complete
+    };
+
+    int _time_budget;
+    quint64 _node_budget;
+    TranspositionTable _table;
+
+    // state of the running search
+    QElapsedTimer _timer;
+    std::atomic<quint64> _nodes;
+    std::atomic<bool> _stopped; // set when a budget ran out, the running iterations are dropped
+    int _completed_depth;
+
+    void iterate(Worker &worker, int first_depth);
+    int search(Worker &worker, int depth, int ply, int alpha, int beta);
+    bool outOfBudget(Worker &worker);
+    bool isStopped() const {return _stopped.load(std::memory_order_relaxed);}
+    static int evaluate(const Position &position);
+    static int toTable(int score, int ply);
+    static int fromTable(int score, int ply);
+};
+
+#endif // SEARCHLOGIC_H
@@ -86,9 +86,10 @@ void ShobuModel::resetMove()
     }
 }
 
-// stops measuring time
+// stops measuring time and the machine player
 void ShobuModel::endGame()
 {
+    cancelMove();
     _timer->stop();
     _ticking = false;
 }
@@ -97,6 +98,7 @@ void ShobuModel::endGame()
 void ShobuModel::changeSettings(GameSettings settings)
 {
     _timer->stop(); // we will restart it later
+    cancelMove();   // the machine player is replaced
 
     int passed_time[2] = {0};
 
@@ -154,10 +156,12 @@ bool ShobuModel::undoStep()
     {
         return false;
     }
-    if (!_persistence->undoStep(backstep))
+    if (!_persistence->hasBackState(backstep))
     {
         return false;
     }
+    cancelMove(); // the machine player was thinking about the undone state
+    _persistence->undoStep(backstep);
 
     // no move in progress
     _move_ready        = false;
@@ -179,10 +183,12 @@ bool ShobuModel::redoStep()
     {
         return false;
     }
-    if (!_persistence->redoStep(step))
+    if (!_persistence->hasForwardState(step))
     {
         return false;
     }
+    cancelMove(); // the machine player was thinking about the replaced state
+    _persistence->redoStep(step);
 
     // no move in progress
     _move_ready        = false;
@@ -312,6 +318,7 @@ void ShobuModel::applySettings()
     // player settings
     if (_players[WHITE] != nullptr)
     {
+        cancelMove(); // no move may arrive from the old players
         _players[WHITE]->deleteLater();
         _players[BLACK]->deleteLater();
     }
@@ -323,16 +330,13 @@ void ShobuModel::applySettings()
     }
     else if (_settings.style == SOLO)
     {
-        if (_settings.color == WHITE)
-        {
-            _players[WHITE] = new OrganicPlayer(_move, WHITE, this);
-            _players[BLACK] = new MachinePlayer(_move, BLACK, _settings.difficulty, this);
-        }
-        else
-        {
-            _players[BLACK] = new OrganicPlayer(_move, BLACK, this);
-            _players[WHITE] = new MachinePlayer(_move, WHITE, _settings.difficulty, this);
-        }
+        Color machine_color = _settings.color == WHITE ? BLACK : WHITE;
+        MachinePlayer *machine = new MachinePlayer(_move, machine_color, _settings.difficulty, this);
+        machine->setPondering(_settings.pondering && _settings.difficulty == EXPERT);
+        machine->setMonteCarlo(_settings.monte_carlo);
+
+        _players[_settings.color] = new OrganicPlayer(_move, _settings.color, this);
+        _players[machine_color] = machine;
     }
 
     // on network game client receives its player
@@ -367,7 +371,7 @@ void ShobuModel::applyMove()
     }
     else // save only when local game
     {
-        _persistence->saveState();
+        _persistence->saveMove(_move->move);
     }
 
 
@@ -377,10 +381,27 @@ void ShobuModel::applyMove()
 
     _ticking = true; // ticking resumes in case the player paused it
 
+    if (_settings.style == SOLO && _settings.color == _game->getTurn()) // the machine player can use the time of the player
+    {
+        _players[_game->getOpponent()]->ponder();
+    }
 
     emit stepGame();
 }
 
+// stops the machine player if it is searching, its move is dropped
+void ShobuModel::cancelMove()
+{
+    _move_ready = false;
+    for (ShobuPlayer *player : _players)
+    {
+        if (player != nullptr)
+        {
+            player->cancelMove();
+        }
+    }
+}
+
 // Timer
 // decreases remaining time if needed when _timer has timeout()
 void ShobuModel::tick()
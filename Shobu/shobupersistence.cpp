@@ -12,6 +12,7 @@
 ShobuPersistence::ShobuPersistence(GameState *state, QObject *parent) : QObject(parent)
 {
     _game = state;
+    _start.initializeGame();
 
     top = -1;
     current = -1;
@@ -20,24 +21,25 @@ ShobuPersistence::ShobuPersistence(GameState *state, QObject *parent) : QObject(
 // prepare for a new game
 void ShobuPersistence::initialize()
 {
-    //clear states from previous game and save the starting state
-    clearVector();
-    saveState();
+    //clear moves from previous game and save the starting state
+    _moves.clear();
+    _start = _game->getPosition();
+
+    top = 0;
+    current = 0;
 }
 
-// save current state
-void ShobuPersistence::saveState()
+// save a move that has been made on the current state
+void ShobuPersistence::saveMove(Move move)
 {
     // remove saved forward steps
     while (current < top)
     {
-        _states[top--]->deleteLater();
-        _states.pop_back();
+        _moves.pop_back();
+        --top;
     }
-    // save current state
-    GameState *new_state = new GameState(this);
-    new_state->setState(_game);
-    _states.push_back(new_state);
+    // save move
+    _moves.push_back(PackedMove(move));
     ++top;
     ++current;
 }
@@ -64,7 +66,17 @@ bool ShobuPersistence::undoStep(int backstep)
         return false;
     }
     current = current - backstep;
-    _game->setState(_states[current]);
+    if (_game->getHistoryLength() >= backstep) // undo from the history of the game if it goes back far enough
+    {
+        for (int i = 0; i < backstep; ++i)
+        {
+            _game->pop();
+        }
+    }
+    else
+    {
+        restoreState();
+    }
     return true;
 }
 
@@ -75,8 +87,11 @@ bool ShobuPersistence::redoStep(int step)
     {
         return false;
     }
+    for (int i = current; i < current + step; ++i) // redo the moves on the current state
+    {
+        _game->makeMove(_moves[i]);
+    }
     current = current + step;
-    _game->setState(_states[current]);
     return true;
 }
 
@@ -105,6 +120,7 @@ bool ShobuPersistence::saveGame(QString filename, GameSettings settings)
         stream << SOLO << endl;
         stream << settings.color << endl;
         stream << settings.difficulty << endl;
+        // pondering and the search are not part of a save, a loaded game keeps the current choice
         break;
 
     case HOTSEAT:
@@ -180,7 +196,7 @@ bool ShobuPersistence::loadGame(const QString &filename, GameSettings &settings)
             return false; // if side is not white or black, load fails
         }
         input = stream.readLine().toInt();
-        if (Difficulty diff = static_cast<Difficulty>(input); diff == EASY || diff == MEDIUM || diff == HARD)
+        if (Difficulty diff = static_cast<Difficulty>(input); diff == EASY || diff == MEDIUM || diff == HARD || diff == EXPERT)
         {
             settings.difficulty = diff;
         }
@@ -307,13 +323,12 @@ bool ShobuPersistence::loadGame(const QString &filename, GameSettings &settings)
 
 // PRIVATE
 
-// remove previous states from vector
-void ShobuPersistence::clearVector()
+// replay the saved moves from the start state until the current one
+void ShobuPersistence::restoreState()
 {
-    // free memory, then remove pointers
-    qDeleteAll(_states);
-    _states.clear();
-
-    top = -1;
-    current = -1;
+    _game->setPosition(_start);
+    for (int i = 0; i < current; ++i)
+    {
+        _game->makeMove(_moves[i]); // recorded in the history of the game, later undos need no replay
+    }
 }
@@ -5,8 +5,7 @@
 #include <QVector>
 
 #include "gameutils.h"
-
-class GameState;
+#include "gamestate.h"
 
 class ShobuPersistence : public QObject
 {
@@ -24,17 +23,18 @@ public:
 
     bool undoStep(int backstep);
     bool redoStep(int step);
-    void saveState();
+    void saveMove(Move move);
 
     bool hasBackState(int backstep) const {return current>=backstep;}
     bool hasForwardState(int step) const {return current+step<=top;}
 
     private:
     GameState *_game;
-    QVector<GameState*> _states;
+    Position _start;            // the position before the first saved move
+    QVector<PackedMove> _moves; // moves made since the start state, including the undone ones
     int top, current;
 
-    void clearVector();
+    void restoreState();
 };
 
 #endif // SHOBUPERSISTENCE_H
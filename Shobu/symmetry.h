@@ -0,0 +1,54 @@
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include <QtGlobal>
+
+#include "position.h"
+
+// One of the 32 transformations that keep the rules of the game:
+// a rotation or reflection of the fields, applied to every board at once (bits 0-2),
+// swapping the two boards of each homeboard pair (bit 3)
+// and swapping the colors together with their homeboards and the turn (bit 4)
+class Symmetry
+{
+public:
+    enum { COUNT = 32 };
+
+    // Constructors
+    Symmetry() : _id(0) {} // identity
+    explicit Symmetry(int id) : _id(id) {}
+
+    // Getters
+    int toInt() const {return _id;}
+    Symmetry inverse() const;
+
+    // Transformations
+    Position apply(const Position &position) const;
+    PackedMove apply(PackedMove move) const;
+    Move apply(const Move &move) const {return apply(PackedMove(move)).toMove();}
+
+    // finds the smallest transformed position, returns the symmetry that maps the position to it
+    static Symmetry canonicalize(const Position &position, Position &canonical);
+    static Position getCanonical(const Position &position);
+    static quint64 canonicalHash(const Position &position) {return getCanonical(position).hash();}
+
+    // gets one move for each class of resulting positions related by the symmetries of the position, returns the number of removed moves
+    static int getUniqueMoves(const Position &position, MoveList &moves);
+
+    // Operators
+    bool operator==(Symmetry other) const {return _id == other._id;}
+    bool operator!=(Symmetry other) const {return _id != other._id;}
+
+private:
+    int _id;
+
+    int transformField(int field) const;
+    int transformDirection(int direction) const;
+    int transformBoard(int board_id) const {return board_id ^ ((_id >> 3 & 1) | (_id >> 4 & 1) << 1);}
+    quint16 transformMask(quint16 mask) const;
+    bool swapsColors() const {return _id >> 4 & 1;}
+
+    static bool isLess(const Position &first, const Position &second);
+};
+
+#endif // SYMMETRY_H
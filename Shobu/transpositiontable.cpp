@@ -0,0 +1,108 @@
+#include "transpositiontable.h"
+
+#include <QtAlgorithms>
+
+// PUBLIC
+
+// Constructor
+TranspositionTable::TranspositionTable(int megabytes) : _mask(0), _age(0)
+{
+    resize(megabytes);
+}
+
+// allocates the largest power of two buckets that fits into the given size, at least one
+void TranspositionTable::resize(int megabytes)
+{
+    quint64 count = (static_cast<quint64>(qMax(megabytes, 0)) << 20) / sizeof(Bucket);
+    quint64 buckets = 1;
+    while (buckets * 2 <= count)
+    {
+        buckets *= 2;
+    }
+
+    _buckets.reset(new Bucket[buckets]);
+    _mask = buckets - 1;
+    clear();
+}
+
+// forgets every entry
+void TranspositionTable::clear()
+{
+    for (quint64 i = 0; i <= _mask; ++i)
+    {
+        for (int j = 0; j < BUCKET_SIZE; ++j)
+        {
+            _buckets[static_cast<int>(i)].entries[j][0].store(0, std::memory_order_relaxed);
+            _buckets[static_cast<int>(i)].entries[j][1].store(0, std::memory_order_relaxed);
+        }
+    }
+    _age = 0;
+}
+
+// looks up the entry of the key, returns false if it is not stored
+bool TranspositionTable::probe(quint64 key, TranspositionEntry &entry) const
+{
+    const Bucket &bucket = _buckets[static_cast<int>(key & _mask)];
+    for (int i = 0; i < BUCKET_SIZE; ++i)
+    {
+        quint64 data = bucket.entries[i][1].load(std::memory_order_relaxed);
+        quint64 checked = bucket.entries[i][0].load(std::memory_order_relaxed) ^ data;
+        Bound bound = static_cast<Bound>(data >> 56 & 3);
+        if (checked == key && bound != NO_BOUND)
+        {
+            entry.score = static_cast<qint32>(static_cast<quint32>(data));
+            entry.move = PackedMove(static_cast<quint16>(data >> 32));
+            entry.depth = packedDepth(data);
+            entry.bound = bound;
+            return true;
+        }
+    }
+    return false;
+}
+
+// stores a result over the same key, an empty entry, or the entry with the least depth from the oldest search
+void TranspositionTable::store(quint64 key, int depth, Bound bound, int score, PackedMove move)
+{
+    Bucket &bucket = _buckets[static_cast<int>(key & _mask)];
+
+    int replaced = 0;
+    int lowest = 0;
+    for (int i = 0; i < BUCKET_SIZE; ++i)
+    {
+        quint64 data = bucket.entries[i][1].load(std::memory_order_relaxed);
+        quint64 checked = bucket.entries[i][0].load(std::memory_order_relaxed) ^ data;
+        if (checked == key || !(data >> 56 & 3)) // the same position or an empty entry
+        {
+            if (!move.toInt() && checked == key)
+            {
+                move = PackedMove(static_cast<quint16>(data >> 32)); // keep the known best move
+            }
+            replaced = i;
+            break;
+        }
+
+        // every search of age difference counts as much as eight plies of depth
+        int value = packedDepth(data) - 8 * ((_age - packedAge(data)) & AGE_MASK);
+        if (i == 0 || value < lowest)
+        {
+            replaced = i;
+            lowest = value;
+        }
+    }
+
+    quint64 data = pack(depth, bound, score, move, _age);
+    bucket.entries[replaced][0].store(key ^ data, std::memory_order_relaxed);
+    bucket.entries[replaced][1].store(data, std::memory_order_relaxed);
+}
+
+// PRIVATE
+
+// score in bits 0-31, move in 32-47, depth in 48-55, bound in 56-57, age in 58-63
+quint64 TranspositionTable::pack(int depth, Bound bound, int score, PackedMove move, int age)
+{
+    return static_cast<quint64>(static_cast<quint32>(score))
+           | static_cast<quint64>(move.toInt()) << 32
+           | static_cast<quint64>(qBound(0, depth, 255)) << 48
+           | static_cast<quint64>(bound) << 56
+           | static_cast<quint64>(age) << 58;
+}
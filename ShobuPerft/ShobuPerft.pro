@@ -0,0 +1,17 @@
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+SOURCES += \
+        gamestate.cpp \
+        main.cpp \
+        perft.cpp \
+        position.cpp
+
+HEADERS += \
+    gamestate.h \
+    gameutils.h \
+    perft.h \
+    position.h \
+    shobuexception.h
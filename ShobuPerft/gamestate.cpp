@@ -0,0 +1,95 @@
+#include "gamestate.h"
+
+#include <QScopedPointer>
+
+#include "shobuexception.h"
+
+// PUBLIC
+
+// Getters
+// returns the MoveIndex of the current position, builds it if the position changed since the last call
+const MoveIndex &GameState::getMoveIndex() const
+{
+    if (!_index_valid)
+    {
+        _index = _position.getMoveIndex();
+        _index_valid = true;
+    }
+    return _index;
+}
+
+// Setters
+// copy state of another GameState
+void GameState::setState(const GameState *from_state)
+{
+    if (from_state == nullptr)
+    {
+        QScopedPointer<ShobuException> exept_ptr(new ShobuException());
+        exept_ptr->setMessage("Nullpointer exception");
+        exept_ptr->raise();
+    }
+
+    _position = from_state->_position; // Position is copied by value
+    changed();
+}
+
+// Step functions
+// applies a legal move and records it in the history, throws on illegal moves
+void GameState::push(Move move)
+{
+    if (_history_top == _history.length()) // below the capacity
+    {
+        _history.append(UndoRecord());
+    }
+    UndoRecord &record = _history[_history_top];
+    record.hash = _position.hash();
+    record.move = PackedMove(move);
+
+    ReverseData reverse = _position.applyMove(move); // throws before the history changes
+    _index_valid = false;
+
+    record.has_push = reverse.has_push;
+    record.on_board = reverse.on_board;
+    record.pushed_from = reverse.has_push ? reverse.pushed_from.board*16 + reverse.pushed_from.row*4 + reverse.pushed_from.column : 0;
+    record.pushed_to = reverse.on_board ? reverse.pushed_to.board*16 + reverse.pushed_to.row*4 + reverse.pushed_to.column : 0;
+
+    _history_top = (_history_top + 1) % HISTORY_CAPACITY;
+    if (_history_length < HISTORY_CAPACITY)
+    {
+        ++_history_length;
+    }
+}
+
+// undoes the last move of the history, throws if the history is empty
+void GameState::pop()
+{
+    if (_history_length == 0)
+    {
+        QScopedPointer<ShobuException> exept_ptr(new ShobuException());
+        exept_ptr->setMessage("No move to undo");
+        exept_ptr->raise();
+    }
+
+    _history_top = (_history_top + HISTORY_CAPACITY - 1) % HISTORY_CAPACITY;
+    --_history_length;
+    const UndoRecord &record = _history[_history_top];
+
+    ReverseData reverse;
+    reverse.has_push = record.has_push;
+    reverse.on_board = record.on_board;
+    reverse.pushed_from = Coordinate(record.pushed_from/16, (record.pushed_from%16)/4, record.pushed_from%4);
+    reverse.pushed_to = Coordinate(record.pushed_to/16, (record.pushed_to%16)/4, record.pushed_to%4);
+
+    _position.reverseUnchecked(record.move, reverse);
+    _index_valid = false;
+    Q_ASSERT(_position.hash() == record.hash);
+}
+
+// returns a new GameState with a move applied to it
+GameState* GameState::getApplied(Move move)
+{
+    GameState *ret = new GameState();
+    ret->setPosition(_position.getApplied(move));
+
+    return ret;
+}
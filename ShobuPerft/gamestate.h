@@ -0,0 +1,108 @@
+#ifndef GAMESTATE_H
+#define GAMESTATE_H
+
+#include <QObject>
+#include <QVector>
+
+#include "position.h"
+
+// Undo entry of the GameState history, packed into 16 bytes
+struct UndoRecord
+{
+    quint64 hash;        // key of the position before the move
+    PackedMove move;
+    quint8 pushed_from;  // board*16 + field of the pushed piece, if has_push is true
+    quint8 pushed_to;    // board*16 + field the piece was pushed to, if on_board is true
+    bool has_push;
+    bool on_board;
+};
+
+static_assert(sizeof(UndoRecord) == 16, "UndoRecord should stay compact");
+
+// Wraps the Position of the current game for the GUI and the network
+class GameState : public QObject
+{
+    Q_OBJECT
+public:
+    enum { HISTORY_CAPACITY = 1024 }; // the oldest moves are dropped from a full history
+
+    GameState(QObject *parent = nullptr) : QObject(parent), _index_valid(false), _history_top(0), _history_length(0){};
+
+    void initializeGame() {_position.initializeGame(); changed();}
+
+    // Getters
+    const Position &getPosition() const {return _position;}
+    const MoveIndex &getMoveIndex() const;
+    Color getField(int table, int row, int column) const {return _position.getField(table, row, column);}
+    quint16 getPieceMask(int board_id, Color color) const {return _position.getPieceMask(board_id, color);}
+    int getPieceCount(int board_id, Color color) const {return _position.getPieceCount(board_id, color);}
+    Color getTurn() const {return _position.getTurn();}
+    quint64 hash() const {return _position.hash();}
+    int getHistoryLength() const {return _history_length;}
+    static Color getOpponent(Color color) {return Position::getOpponent(color);}
+    Color getOpponent() const {return _position.getOpponent();}
+
+    static bool isHomeBoard(Color color, int board_id) {return Position::isHomeBoard(color, board_id);}
+
+    // Setter
+    void setPosition(const Position &position) {_position = position; changed();}
+    void setState(const GameState *fromState);
+    void setField(int table, int row, int column, Color color) {_position.setField(table, row, column, color); changed();}
+    void setTurn(Color color) {_position.setTurn(color); changed();}
+
+    // Step functions
+    void makeMove(Move move) {if (isLegalMove(move)) {push(move);}} // illegal moves are ignored
+    void endTurn() {_position.endTurn(); changed();}
+    Color getVictor() const {return _position.getVictor();}
+
+    bool hasMoves() const {return _position.hasMoves();}
+
+    bool isLegalMove(Move move) const {return _position.isLegalMove(move);}
+
+    // Player needs to verify by steps
+    bool isLegalPassive(Coordinate coord) const {return _position.isLegalPassive(coord);}
+    bool isLegalVector(Coordinate p, int row_change, int col_change, int magnitude) const {return _position.isLegalVector(p, row_change, col_change, magnitude);}
+    bool isLegalAgressive(Move move) const {return _position.isLegalAgressive(move);}
+    bool isLegalAgressive(Coordinate a, int row_change, int col_change, int magnitude) const {return _position.isLegalAgressive(a, row_change, col_change, magnitude);}
+
+    // Step finder functions
+    void getMoves(Color color, MoveList &moves) const {_position.getMoves(color, moves);}
+    void getMoves(MoveList &moves) const {_position.getMoves(moves);}
+    QVector<Move> getMoves(Color color) const {return _position.getMoves(color);}
+    QVector<Move> getMoves() const {return _position.getMoves();};
+    void getPushes(MoveList &moves) const {_position.getPushes(moves);}
+    void getPushOffs(MoveList &moves) const {_position.getPushOffs(moves);}
+
+    // answered from the MoveIndex of the current position, built once after each change
+    QVector<Coordinate> getPassivePieces(int board_index) const {return getMoveIndex().getPassivePieces(board_index);}
+    QVector<Coordinate> getDestinations(int board_index, Coordinate passive) const {return getMoveIndex().getDestinations(board_index, passive);}
+    QVector<Coordinate> getAgressivePieces(int board_index, Coordinate passive, int row_change, int col_change, int magnitude) const
+    {return getMoveIndex().getAgressivePieces(board_index, passive, row_change, col_change, magnitude);}
+
+    GameState* getApplied(Move move);
+
+    // moves recorded in the history, undone in reverse order by pop
+    void push(Move move);
+    void pop();
+
+private:
+    void changed() {_index_valid = false; _history_length = 0;} // the position was replaced, the history is no longer valid
+
+    Position _position;
+    mutable MoveIndex _index;  // legal move parts of _position, only valid if _index_valid is true
+    mutable bool _index_valid; // cleared by every change of _position
+
+    QVector<UndoRecord> _history; // ring buffer grown by push up to HISTORY_CAPACITY, the last pushed move is before _history_top
+    int _history_top;
+    int _history_length;
+};
+
+struct MoveState // the players and the game communicate through this
+{
+    Move move;
+    GameState *game;
+    bool passive_set;
+    bool vector_set;
+};
+
+#endif // GAMESTATE_H
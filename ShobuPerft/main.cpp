@@ -0,0 +1,72 @@
+#include <QCoreApplication>
+#include <QStringList>
+#include <QTextStream>
+
+#include "perft.h"
+
+enum PerftDefaults
+{
+    DEFAULT_DEPTH = 3
+};
+
+// usage: ShobuPerft [--divide] [depth] [position]
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QTextStream out(stdout);
+
+    bool divide = false;
+    int depth = DEFAULT_DEPTH;
+    QString position;
+
+    QStringList arguments = a.arguments();
+    for (int i = 1; i < arguments.length(); ++i)
+    {
+        bool is_number = false;
+        int number = arguments[i].toInt(&is_number);
+
+        if (arguments[i] == "-d" || arguments[i] == "--divide")
+        {
+            divide = true;
+        }
+        else if (is_number && number >= 0)
+        {
+            depth = number;
+        }
+        else
+        {
+            position = arguments[i];
+        }
+    }
+
+    GameState state;
+    state.initializeGame();
+    if (!position.isEmpty() && !Perft::loadPosition(&state, position))
+    {
+        out << "Invalid position, expected 64 fields of w, b or . and the color to move" << endl;
+        return 1;
+    }
+
+    Perft perft(&state);
+    if (divide)
+    {
+        QVector<PerftDivision> divisions = perft.divide(depth);
+        quint64 total = 0;
+        for (const PerftDivision &division : divisions)
+        {
+            out << Perft::formatMove(division.move) << ": " << division.nodes << endl;
+            total += division.nodes;
+        }
+        out << "moves: " << divisions.length() << ", nodes: " << total << endl;
+        return 0;
+    }
+
+    // count every depth up to the requested one to show how the tree grows
+    for (int i = 1; i <= depth; ++i)
+    {
+        PerftResult result = perft.run(i);
+        out << "perft " << result.depth << ": " << result.nodes << " nodes, "
+            << result.elapsed << " ms, " << result.nodesPerSecond() << " nodes/s" << endl;
+    }
+    return 0;
+}
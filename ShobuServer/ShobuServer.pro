@@ -12,6 +12,7 @@ SOURCES += \
         gamestate.cpp \
         main.cpp \
         onlinegame.cpp \
+        position.cpp \
         remoteplayer.cpp \
         shobuserver.cpp
 
@@ -24,5 +25,6 @@ HEADERS += \
     gamestate.h \
     gameutils.h \
     onlinegame.h \
+    position.h \
     remoteplayer.h \
     shobuserver.h
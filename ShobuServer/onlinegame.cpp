@@ -48,7 +48,7 @@ void OnlineGame::makeMove(Move move, Color color)
     {
         if (_game->isLegalMove(move)) // if everything is well, make move and notify opponent
         {
-            _game->applyMove(move);
+            _game->push(move);
 
             // a move automatically refuses draw offers
             _draw_offered[WHITE] = false;
@@ -0,0 +1,268 @@
+#ifndef POSITION_H
+#define POSITION_H
+
+#include <QVector>
+#include <QtGlobal>
+
+#include <type_traits>
+
+#include "gameutils.h"
+
+// Contains the coordinate of a field
+struct Coordinate
+{
+    int board, row, column;
+
+    // Constructors
+    Coordinate(): board(0), row(0), column(0){};
+    Coordinate(int b, int r, int c): board(b), row(r), column(c){}
+
+    // Operators
+    bool operator==(const Coordinate& c) { return board==c.board && row==c.row && column==c.column;}
+};
+
+// Contains the pieces and the vector of the move
+struct Move
+{
+    Coordinate p;                 // coordinates of the passive piece
+    Coordinate a;                 // coordinates of the agressive piece
+    int row_change, col_change;   // change on the given coordinate (-1, 0, 1)
+    int magnitude;                // magnitude of the change (1, 2)
+
+    // Constructors
+    Move(): p(Coordinate()), a(Coordinate()), row_change(1), col_change(1), magnitude(1) {};
+    Move(Coordinate pass, Coordinate agr, int rc, int cc, int m) : p(pass), a(agr), row_change(rc), col_change(cc), magnitude(m) {};
+};
+
+// Contains a move in 16 bits: boards and fields of the pieces, direction and magnitude of the vector
+class PackedMove
+{
+public:
+    // Constructors
+    PackedMove() = default; // uninitialized, like a plain integer
+    explicit PackedMove(quint16 data) : _data(data) {}
+    explicit PackedMove(const Move &move) : PackedMove(move.p.board, move.p.row*4 + move.p.column, move.a.board, move.a.row*4 + move.a.column,
+                                                      toDirection(move.row_change, move.col_change), move.magnitude) {}
+    PackedMove(int p_board, int p_field, int a_board, int a_field, int direction, int magnitude)
+        : _data(p_board | p_field << 2 | a_board << 6 | a_field << 8 | direction << 12 | (magnitude-1) << 15) {}
+
+    // Getters
+    quint16 toInt() const {return _data;}
+    int passiveBoard() const {return _data & 3;}
+    int passiveField() const {return (_data >> 2) & 15;}
+    int agressiveBoard() const {return (_data >> 6) & 3;}
+    int agressiveField() const {return (_data >> 8) & 15;}
+    int direction() const {return (_data >> 12) & 7;}
+    int magnitude() const {return (_data >> 15) + 1;}
+
+    // Conversion
+    Move toMove() const {return Move(Coordinate(passiveBoard(), passiveField()/4, passiveField()%4), Coordinate(agressiveBoard(), agressiveField()/4, agressiveField()%4),
+                                     rowChange(direction()), colChange(direction()), magnitude());}
+    operator Move() const {return toMove();}
+
+    // directions are numbered in row major order, skipping the zero vector
+    static constexpr int toDirection(int row_change, int col_change) {int i = (row_change+1)*3 + col_change+1; return i < 4 ? i : i-1;}
+    static constexpr int rowChange(int direction) {return (direction < 4 ? direction : direction+1) / 3 - 1;}
+    static constexpr int colChange(int direction) {return (direction < 4 ? direction : direction+1) % 3 - 1;}
+
+    // Operators
+    bool operator==(PackedMove other) const {return _data == other._data;}
+    bool operator!=(PackedMove other) const {return _data != other._data;}
+
+private:
+    quint16 _data;
+};
+
+inline uint qHash(PackedMove move, uint seed = 0) {return move.toInt() ^ seed;}
+
+// Fixed capacity list of moves, filled by the step finder functions without any heap allocation
+class MoveList
+{
+public:
+    enum { CAPACITY = 1024 }; // 16 vectors on 4 board pairs, each with at most 4 passive and 4 agressive pieces
+
+    MoveList() : _length(0) {}
+
+    void append(PackedMove move) {Q_ASSERT(_length < CAPACITY); _moves[_length++] = move;}
+    void clear() {_length = 0;}
+    void truncate(int length) {Q_ASSERT(length <= _length); _length = length;}
+
+    int length() const {return _length;}
+    bool isEmpty() const {return _length == 0;}
+
+    PackedMove &operator[](int i) {return _moves[i];}
+    PackedMove operator[](int i) const {return _moves[i];}
+    const PackedMove *begin() const {return _moves;}
+    const PackedMove *end() const {return _moves + _length;}
+
+private:
+    PackedMove _moves[CAPACITY]; // not initialized, only the first _length moves are valid
+    int _length;
+};
+
+// Contains data needed to reverse a move besides the move
+struct ReverseData
+{
+    bool has_push;           // true, if there has been a push
+    Coordinate pushed_from;  // if has_pushed is true, this contains the original coordinates of the pushed piece
+    bool on_board;           // true, if has_pushed is true and the pushed piece remained on the board
+    Coordinate pushed_to;    // if on_board is true, this contains the destination coordinates of the pushed piece
+};
+
+// Groups of moves for staged generation, in the order they are generated
+enum MoveStage
+{
+    WINNING_PUSHES = 0, // pushes off the last opposing piece of a board
+    PUSHES         = 1, // every other push
+    QUIET_MOVES    = 2, // moves without a push
+    STAGE_COUNT    = 3
+};
+
+// Legal parts of the moves of one position and turn as bitmasks, built by Position::getMoveIndex
+// vectors are numbered as direction*2 + magnitude-1, so a mask of vectors also fits in 16 bits
+class MoveIndex
+{
+public:
+    // Getters
+    quint16 getPassiveMask(int board_id) const {return _passives[board_id];}
+    quint16 getVectorMask(int board_id, int field) const {return _vectors[board_id][field];}
+    quint16 getAgressiveMask(int board_id, int vector) const {return _agressives[board_id][vector];}
+
+    QVector<Coordinate> getPassivePieces(int board_index) const;
+    QVector<Coordinate> getDestinations(int board_index, Coordinate passive) const;
+    QVector<Coordinate> getAgressivePieces(int board_index, Coordinate passive, int row_change, int col_change, int magnitude) const;
+
+    static int toVector(int direction, int magnitude) {return direction*2 + magnitude-1;}
+
+private:
+    quint16 _passives[4];       // passive pieces that are part of a legal move
+    quint16 _vectors[4][16];    // legal vectors of each passive piece
+    quint16 _agressives[4][16]; // pieces that can make each vector as agressive, whatever the passive board is
+
+    friend class Position;
+};
+
+// Contains the pieces and the turn of a game, trivially copyable so it can be stored and passed by value
+class Position
+{
+public:
+    Position() = default; // uninitialized, call initializeGame or copy another position
+
+    void initializeGame();
+
+    // Getters
+    Color getField(int table, int row, int column) const;
+    quint16 getPieceMask(int board_id, Color color) const {return _pieces[board_id][color];}
+    int getPieceCount(int board_id, Color color) const {return qPopulationCount(_pieces[board_id][color]);}
+    Color getTurn() const {return static_cast<Color>(_turn);}
+    quint64 hash() const {return _hash;} // Zobrist key of the pieces and the turn
+    static Color getOpponent(Color color) {return color == WHITE ? BLACK : WHITE;}
+    Color getOpponent() const {return getOpponent(getTurn());}
+
+    static bool isHomeBoard(Color color, int board_id);
+
+    // Setter
+    void setField(int table, int row, int column, Color color);
+    void setTurn(Color color);
+
+    // Step functions
+    void makeMove(Move move);
+    void endTurn();
+    Color getVictor() const;
+
+    bool hasMoves() const;
+
+    bool isLegalMove(Move move) const;
+
+    // Player needs to verify by steps
+    bool isLegalPassive(Coordinate coord) const;
+    bool isLegalVector(Coordinate p, int row_change, int col_change, int magnitude) const;
+    bool isLegalAgressive(Move move) const;
+    bool isLegalAgressive(Coordinate a, int row_change, int col_change, int magnitude) const; // without board check
+
+    // Step finder functions
+    void getMoves(Color color, MoveList &moves) const;
+    void getMoves(MoveList &moves) const {getMoves(getTurn(), moves);}
+    QVector<Move> getMoves(Color color) const;
+    QVector<Move> getMoves() const {return getMoves(getTurn());};
+    void getMoves(MoveStage stage, MoveList &moves) const; // the moves of getMoves for the player to move, one stage at a time
+    void getPushes(MoveList &moves) const;   // moves of the player to move that push an opposing piece
+    void getPushOffs(MoveList &moves) const; // pushes that remove the opposing piece from its board
+
+    QVector<Coordinate> getPassivePieces(int board_index) const;
+    QVector<Coordinate> getDestinations(int board_index, Coordinate passive) const;
+    QVector<Coordinate> getAgressivePieces(int board_index, Coordinate passive, int row_change, int col_change, int magnitude) const;
+    MoveIndex getMoveIndex() const;
+
+    Position getApplied(Move move) const;
+    ReverseData applyMove(Move move);
+    void reverseMove(Move move, ReverseData data);
+
+    // for moves of the step finder functions, legality is only asserted in debug builds
+    ReverseData applyUnchecked(PackedMove move);
+    void reverseUnchecked(PackedMove move, ReverseData data);
+
+    // Operators
+    bool operator==(const Position &other) const;
+    bool operator!=(const Position &other) const {return !(*this == other);}
+
+private:
+    quint16 _pieces[4][2]; // one bit per field (row*4 + column) for each board and color, piece counts are their popcounts
+    quint8 _turn;          // Color of the player to move
+    quint64 _hash;         // Zobrist key, follows _pieces and _turn
+
+    static bool onBoard(int x, int y);
+    static quint64 toggleKey(int board_id, int color, quint16 mask);
+    quint64 computeHash() const;
+    static int toSquare(int row, int column) {return row*4 + column;}
+    static quint16 lookAhead(quint16 mask, int row_change, int col_change, int distance);
+
+    // the generators and checks below are instantiated for each side, so the homeboards are constants
+    template<Color color> static constexpr int homeId() {return color == WHITE ? 2 : 0;}
+    template<Color color> static constexpr Color opponentOf() {return color == WHITE ? BLACK : WHITE;}
+    template<Color color> bool hasMovesFor() const;
+    template<Color color> bool isLegalPassiveFor(Coordinate coord) const;
+
+    // Step finder functions
+    static quint16 getPassives(quint16 occupied, int row_change, int col_change, int magnitude);
+    static quint16 getAgressives(quint16 own, quint16 opponent, int row_change, int col_change, int magnitude);
+    static void addMoves(MoveList &moves, int p_board, quint16 passives, int a_board, quint16 agressives, int direction, int magnitude);
+    template<Color color> void getMovesFor(MoveList &moves) const;
+    template<Color color> void getMovesFromBoards(int p_board, int a_board, MoveList &moves) const;
+    template<Color color> void getAgressiveMovesFromBoards(int p_board, int a_board, MoveList &moves) const;
+
+    // kinds of agressive moves for getSelectedMoves, can be combined
+    enum MoveKind
+    {
+        WINNING_PUSH_OFF = 1, // pushes off the last opposing piece of the board
+        PUSH_OFF         = 2, // pushes off any other opposing piece
+        PUSH_ON_BOARD    = 4, // the pushed piece stays on the board
+        QUIET            = 8  // no push
+    };
+    void getSelectedMoves(int kinds, MoveList &moves) const;
+    template<Color color> void getSelectedFor(int kinds, MoveList &moves) const;
+    template<Color color> void getSelectedFromBoards(int p_board, int a_board, int kinds, bool pushes_only, MoveList &moves) const;
+
+    friend class Symmetry;       // transforms the masks and recomputes the key
+    friend class BatchEvaluator; // loads the masks of a position into one register
+};
+
+// Yields the moves of a position stage by stage, a stage is generated only when the previous one ran out
+class StagedMoves
+{
+public:
+    StagedMoves(const Position &position) : _position(position), _stage(WINNING_PUSHES), _index(0) {_position.getMoves(WINNING_PUSHES, _moves);}
+
+    bool next(PackedMove &move); // false if there are no more moves
+    MoveStage getStage() const {return static_cast<MoveStage>(_stage);}
+
+private:
+    Position _position; // copied, the caller may apply and reverse moves between the calls
+    int _stage;
+    MoveList _moves;    // moves of the current stage
+    int _index;         // next move in _moves
+};
+
+static_assert(std::is_trivially_copyable<Position>::value, "Position is copied by value between engines, persistence and threads");
+
+#endif // POSITION_H
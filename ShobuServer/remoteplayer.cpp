@@ -61,18 +61,7 @@ void RemotePlayer::sendMove(Move move)
     QJsonObject json;
 
     json["event"] = MOVE;
-
-    json["p_board"]  = move.p.board;
-    json["p_row"]    = move.p.row;
-    json["p_column"] = move.p.column;
-
-    json["row_change"] = move.row_change;
-    json["col_change"] = move.col_change;
-    json["magnitude"] = move.magnitude;
-
-    json["a_board"]  = move.a.board;
-    json["a_row"]    = move.a.row;
-    json["a_column"] = move.a.column;
+    json["move"]  = PackedMove(move).toInt();
 
     sendJson(json);
 }
@@ -334,82 +323,14 @@ void RemotePlayer::joinGame(const QJsonObject &json)
 // makes a move based on the json
 void RemotePlayer::makeMove(const QJsonObject &json)
 {
-    Move move;
-
-    // passive move
-    QJsonValue json_property = json.value(QLatin1String("p_board"));
-    if (json_property.isNull() || !json_property.isDouble())
-    {
-        sendError();
-        return;
-    }
-    move.p.board = json_property.toInt();
-
-    json_property = json.value(QLatin1String("p_row"));
-    if (json_property.isNull() || !json_property.isDouble())
-    {
-        sendError();
-        return;
-    }
-    move.p.row = json_property.toInt();
-
-    json_property = json.value(QLatin1String("p_column"));
-    if (json_property.isNull() || !json_property.isDouble())
-    {
-        sendError();
-        return;
-    }
-    move.p.column = json_property.toInt();
-
-    // vector
-    json_property = json.value(QLatin1String("row_change"));
-    if (json_property.isNull() || !json_property.isDouble())
-    {
-        sendError();
-        return;
-    }
-    move.row_change = json_property.toInt();
-
-    json_property = json.value(QLatin1String("col_change"));
-    if (json_property.isNull() || !json_property.isDouble())
-    {
-        sendError();
-        return;
-    }
-    move.col_change = json_property.toInt();
-
-    json_property = json.value(QLatin1String("magnitude"));
-    if (json_property.isNull() || !json_property.isDouble())
-    {
-        sendError();
-        return;
-    }
-    move.magnitude = json_property.toInt();
-
-    // agressive move
-    json_property = json.value(QLatin1String("a_board"));
-    if (json_property.isNull() || !json_property.isDouble())
-    {
-        sendError();
-        return;
-    }
-    move.a.board = json_property.toInt();
-
-    json_property = json.value(QLatin1String("a_row"));
-    if (json_property.isNull() || !json_property.isDouble())
-    {
-        sendError();
-        return;
-    }
-    move.a.row = json_property.toInt();
-
-    json_property = json.value(QLatin1String("a_column"));
-    if (json_property.isNull() || !json_property.isDouble())
+    // the move is sent in its packed form, every 16 bit value decodes to a move with valid ranges
+    QJsonValue json_property = json.value(QLatin1String("move"));
+    if (json_property.isNull() || !json_property.isDouble() || json_property.toInt() < 0 || json_property.toInt() > 0xFFFF)
     {
         sendError();
         return;
     }
-    move.a.column = json_property.toInt();
+    Move move = PackedMove(static_cast<quint16>(json_property.toInt()));
 
     _game->makeMove(move, _side);
 }
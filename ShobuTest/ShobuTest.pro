@@ -9,28 +9,43 @@ CONFIG += c++17
 TEMPLATE = app
 
 SOURCES +=  \
+    batchevaluator.cpp \
     gamestate.cpp \
     greedylogic.cpp \
     hardlogic.cpp \
     machineplayer.cpp \
+    montecarlologic.cpp \
     organicplayer.cpp \
+    perft.cpp \
+    position.cpp \
     randomlogic.cpp \
+    searchlogic.cpp \
     shobuclient.cpp \
     shobumodel.cpp \
     shobupersistence.cpp \
+    symmetry.cpp \
+    transpositiontable.cpp \
     tst_main.cpp
 
 HEADERS += \
+    batchevaluator.h \
     gamestate.h \
     gameutils.h \
     greedylogic.h \
     hardlogic.h \
     machinelogic.h \
     machineplayer.h \
+    montecarlologic.h \
     organicplayer.h \
+    parallelfor.h \
+    perft.h \
+    position.h \
     randomlogic.h \
+    searchlogic.h \
     shobuclient.h \
     shobuexception.h \
     shobumodel.h \
     shobupersistence.h \
-    shobuplayer.h
+    shobuplayer.h \
+    symmetry.h \
+    transpositiontable.h
@@ -4,106 +4,97 @@
 #include <QObject>
 #include <QVector>
 
-#include "gameutils.h"
+#include "position.h"
 
-// Contains the coordinate of a field
-struct Coordinate
+// Undo entry of the GameState history, packed into 16 bytes
+struct UndoRecord
 {
-    int board, row, column;
-
-    // Constructors
-    Coordinate(): board(0), row(0), column(0){};
-    Coordinate(int b, int r, int c): board(b), row(r), column(c){}
-
-    // Operators
-    bool operator==(const Coordinate& c) { return board==c.board && row==c.row && column==c.column;}
-};
-
-// Contains the pieces and the vector of the move
-struct Move
-{
-    Coordinate p;                 // coordinates of the passive piece
-    Coordinate a;                 // coordinates of the agressive piece
-    int row_change, col_change;   // change on the given coordinate (-1, 0, 1)
-    int magnitude;                // magnitude of the change (1, 2)
-
-    // Constructors
-    Move(): p(Coordinate()), a(Coordinate()), row_change(1), col_change(1), magnitude(1) {};
-    Move(Coordinate pass, Coordinate agr, int rc, int cc, int m) : p(pass), a(agr), row_change(rc), col_change(cc), magnitude(m) {};
+    quint64 hash;        // key of the position before the move
+    PackedMove move;
+    quint8 pushed_from;  // board*16 + field of the pushed piece, if has_push is true
+    quint8 pushed_to;    // board*16 + field the piece was pushed to, if on_board is true
+    bool has_push;
+    bool on_board;
 };
 
-// Contains data needed to reverse a move besides the move
-struct ReverseData
-{
-    bool has_push;           // true, if there has been a push
-    Coordinate pushed_from;  // if has_pushed is true, this contains the original coordinates of the pushed piece
-    bool on_board;           // true, if has_pushed is true and the pushed piece remained on the board
-    Coordinate pushed_to;    // if on_board is true, this contains the destination coordinates of the pushed piece
-};
+static_assert(sizeof(UndoRecord) == 16, "UndoRecord should stay compact");
 
+// Wraps the Position of the current game for the GUI and the network
 class GameState : public QObject
 {
     Q_OBJECT
 public:
-    GameState(QObject *parent = nullptr) : QObject(parent){};
+    enum { HISTORY_CAPACITY = 1024 }; // the oldest moves are dropped from a full history
 
-    void initializeGame();
+    GameState(QObject *parent = nullptr) : QObject(parent), _index_valid(false), _history_top(0), _history_length(0){};
 
-    // Getters
-    Color getField(int table, int row, int column) const {return _board[table][row][column];}
-    Color getTurn() const {return _turn;}
-    static Color getOpponent(Color color) {return color == WHITE ? BLACK : WHITE;}
-    Color getOpponent() const {return getOpponent(_turn);}
+    void initializeGame() {_position.initializeGame(); changed();}
 
-    static bool isHomeBoard(Color color, int board_id);
+    // Getters
+    const Position &getPosition() const {return _position;}
+    const MoveIndex &getMoveIndex() const;
+    Color getField(int table, int row, int column) const {return _position.getField(table, row, column);}
+    quint16 getPieceMask(int board_id, Color color) const {return _position.getPieceMask(board_id, color);}
+    int getPieceCount(int board_id, Color color) const {return _position.getPieceCount(board_id, color);}
+    Color getTurn() const {return _position.getTurn();}
+    quint64 hash() const {return _position.hash();}
+    int getHistoryLength() const {return _history_length;}
+    static Color getOpponent(Color color) {return Position::getOpponent(color);}
+    Color getOpponent() const {return _position.getOpponent();}
+
+    static bool isHomeBoard(Color color, int board_id) {return Position::isHomeBoard(color, board_id);}
 
     // Setter
+    void setPosition(const Position &position) {_position = position; changed();}
     void setState(const GameState *fromState);
-    void setField(int table, int row, int column, Color color);
-    void setTurn(Color color);
+    void setField(int table, int row, int column, Color color) {_position.setField(table, row, column, color); changed();}
+    void setTurn(Color color) {_position.setTurn(color); changed();}
 
     // Step functions
-    void makeMove(Move move);
-    void endTurn();
-    Color getVictor() const;
+    void makeMove(Move move) {if (isLegalMove(move)) {push(move);}} // illegal moves are ignored
+    void endTurn() {_position.endTurn(); changed();}
+    Color getVictor() const {return _position.getVictor();}
 
-    bool hasMoves() const;
+    bool hasMoves() const {return _position.hasMoves();}
 
-    bool isLegalMove(Move move) const;
+    bool isLegalMove(Move move) const {return _position.isLegalMove(move);}
 
     // Player needs to verify by steps
-    bool isLegalPassive(Coordinate coord) const;
-    bool isLegalVector(Coordinate p, int row_change, int col_change, int magnitude) const;
-    bool isLegalAgressive(Move move) const;
-    bool isLegalAgressive(Coordinate a, int row_change, int col_change, int magnitude) const; // without board check
+    bool isLegalPassive(Coordinate coord) const {return _position.isLegalPassive(coord);}
+    bool isLegalVector(Coordinate p, int row_change, int col_change, int magnitude) const {return _position.isLegalVector(p, row_change, col_change, magnitude);}
+    bool isLegalAgressive(Move move) const {return _position.isLegalAgressive(move);}
+    bool isLegalAgressive(Coordinate a, int row_change, int col_change, int magnitude) const {return _position.isLegalAgressive(a, row_change, col_change, magnitude);}
 
     // Step finder functions
-    QVector<Move> getMoves(Color color) const;
-    QVector<Move> getMoves() const {return getMoves(_turn);};
-
-    QVector<Coordinate> getPassivePieces(int board_index) const;
-    QVector<Coordinate> getDestinations(int board_index, Coordinate passive) const;
-    QVector<Coordinate> getAgressivePieces(int board_index, Coordinate passive, int row_change, int col_change, int magnitude) const;
+    void getMoves(Color color, MoveList &moves) const {_position.getMoves(color, moves);}
+    void getMoves(MoveList &moves) const {_position.getMoves(moves);}
+    QVector<Move> getMoves(Color color) const {return _position.getMoves(color);}
+    QVector<Move> getMoves() const {return _position.getMoves();};
+    void getPushes(MoveList &moves) const {_position.getPushes(moves);}
+    void getPushOffs(MoveList &moves) const {_position.getPushOffs(moves);}
+
+    // answered from the MoveIndex of the current position, built once after each change
+    QVector<Coordinate> getPassivePieces(int board_index) const {return getMoveIndex().getPassivePieces(board_index);}
+    QVector<Coordinate> getDestinations(int board_index, Coordinate passive) const {return getMoveIndex().getDestinations(board_index, passive);}
+    QVector<Coordinate> getAgressivePieces(int board_index, Coordinate passive, int row_change, int col_change, int magnitude) const
+    {return getMoveIndex().getAgressivePieces(board_index, passive, row_change, col_change, magnitude);}
 
     GameState* getApplied(Move move);
-    ReverseData applyMove(Move move);
-    void reverseMove(Move move, ReverseData data);
+
+    // moves recorded in the history, undone in reverse order by pop
+    void push(Move move);
+    void pop();
 
 private:
-    Color _board[4][4][4];
-    Color _turn;
+    void changed() {_index_valid = false; _history_length = 0;} // the position was replaced, the history is no longer valid
 
-    bool onBoard(int x, int y) const;
+    Position _position;
+    mutable MoveIndex _index;  // legal move parts of _position, only valid if _index_valid is true
+    mutable bool _index_valid; // cleared by every change of _position
 
-    // Step finder functions
-    QVector<Coordinate> getPieces(int board_id, Color color) const;
-    QVector<Coordinate> getPassives(QVector<Coordinate> coords, int row_change, int col_change, int magnitude) const;
-    QVector<Coordinate> getAgressives(QVector<Coordinate> coords, int row_change, int col_change, int magnitude) const;
-    QVector<Coordinate> getNonPassiveAgressives(QVector<Coordinate> coords, int row_change, int col_change, int magnitude) const;
-    QVector<Move> getMovesFromBoards(QVector<Coordinate> p, QVector<Coordinate> a) const;
-    QVector<Move> getAgressiveMovesFromBoards(QVector<Coordinate> p, QVector<Coordinate> a) const;
-
-    QVector<Move> getAllMoves() const;
+    QVector<UndoRecord> _history; // ring buffer grown by push up to HISTORY_CAPACITY, the last pushed move is before _history_top
+    int _history_top;
+    int _history_length;
 };
 
 struct MoveState // the players and the game communicate through this
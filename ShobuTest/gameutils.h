@@ -14,7 +14,8 @@ enum Difficulty
 {
     EASY = 0,
     MEDIUM = 1,
-    HARD = 2
+    HARD = 2,
+    EXPERT = 3
 };
 
 enum Color
@@ -32,6 +33,8 @@ struct GameSettings
     int time, times[2];
     QString name;
     bool has_time;
+    bool pondering = false; // the machine player searches during the turn of the organic player, not saved
+    bool monte_carlo = false; // the expert machine player uses the Monte Carlo tree search, not saved
 
     QString formatted_time(Color color)
     {
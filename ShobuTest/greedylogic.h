@@ -2,6 +2,7 @@
 #define GREEDYLOGIC_H
 
 #include "machinelogic.h"
+#include "batchevaluator.h"
 
 class GreedyLogic : public MachineLogic
 {
@@ -12,7 +13,9 @@ public:
     Move getMove() override;
 
 private:
-    int evaluateState(const GameState *state);
+    BatchEvaluator _evaluator; // only the piece counts are used, every weight is zero
+
+    int evaluateState(const EvaluationTerms &terms, Color opponent);
 };
 
 #endif // GREEDYLOGIC_H
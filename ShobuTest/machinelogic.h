@@ -3,18 +3,38 @@
 
 #include <QObject>
 
+#include <atomic>
+
 #include "gamestate.h"
 
 class MachineLogic : public QObject
 {
     Q_OBJECT
 public:
-    MachineLogic(GameState *state, QObject *parent = nullptr) : QObject(parent), _state(state) {};
+    MachineLogic(GameState *state, QObject *parent = nullptr) : QObject(parent), _state(state), _thread_count(1), _cancelled(false), _pondering(false) {};
 
     virtual Move getMove() = 0;
 
+    // threads used by getMove, the calling thread included
+    void setThreadCount(int count) {_thread_count = qMax(count, 1);}
+    int getThreadCount() const {return _thread_count;}
+
+    // can be called from another thread, the logics that search long return any legal move when they notice it
+    void cancel() {_cancelled = true;}
+    void clearCancel() {_cancelled = false;}
+    bool isCancelled() const {return _cancelled.load(std::memory_order_relaxed);}
+
+    // a logic that can ponder gives the expected move of the opponent, then searches the position after it
+    // without a budget until the pondering is cleared, which can be done from another thread
+    virtual bool getPonderMove(const Position &, PackedMove &) const {return false;}
+    void setPondering(bool pondering) {_pondering = pondering;}
+    bool isPondering() const {return _pondering.load(std::memory_order_relaxed);}
+
 protected:
     GameState *_state;
+    int _thread_count;
+    std::atomic<bool> _cancelled;
+    std::atomic<bool> _pondering;
 };
 
 #endif // MACHINELOGIC_H
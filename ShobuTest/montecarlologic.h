@@ -0,0 +1,63 @@
+#ifndef MONTECARLOLOGIC_H
+#define MONTECARLOLOGIC_H
+
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QVector>
+
+#include "machinelogic.h"
+
+// Monte Carlo tree search with UCT selection, stops when the time or the playout budget is used up.
+// The tree is kept between the moves, the next search starts from the node of the new position if it is in it
+class MonteCarloLogic : public MachineLogic
+{
+    Q_OBJECT
+public:
+    MonteCarloLogic(GameState *state, QObject *parent = nullptr);
+
+    Move getMove() override;
+
+    // Budgets
+    void setTimeBudget(int msec) {_time_budget = msec;}               // 0 means no time limit
+    void setPlayoutBudget(int playouts) {_playout_budget = playouts;} // 0 means no playout limit
+    int getTimeBudget() const {return _time_budget;}
+    int getPlayoutBudget() const {return _playout_budget;}
+
+    // results of the last getMove
+    int getPlayoutCount() const {return _playouts;}
+    int getRootVisits() const {return _nodes.isEmpty() ? 0 : static_cast<int>(_nodes[0].visits);} // reused visits included
+    int getNodeCount() const {return _nodes.length();}
+
+private:
+    // one position of the tree in 16 bytes, the children of a node are next to each other in the arena
+    struct Node
+    {
+        PackedMove move;     // leads from the parent to this node
+        quint16 child_count; // zero until the node is expanded
+        quint32 first_child; // index in the arena, the root is never a child
+        quint32 visits;
+        float wins;          // sum of the results for the player who made the move
+    };
+    static_assert(sizeof(Node) == 16, "Node should stay compact");
+
+    int _time_budget;
+    int _playout_budget;
+
+    QVector<Node> _nodes; // arena, the root is the first node
+    Position _root_position;
+    QRandomGenerator _random;
+
+    // state of the running search
+    QElapsedTimer _timer;
+    int _playouts;
+
+    void reuseTree(const Position &position);
+    void keepSubtree(int index);
+    void expand(int index, const Position &position);
+    int select(int index) const;
+    float playout(Position &position);
+    bool outOfBudget() const;
+    static float evaluate(const Position &position, Color color);
+};
+
+#endif // MONTECARLOLOGIC_H
@@ -0,0 +1,38 @@
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Calls function(begin, end) for every chunk of [0, count) on up to thread_count threads, the calling thread included.
+// A thread that finished its chunk takes the next free one, so slow chunks do not hold the others back
+template<class Function>
+void parallelFor(int count, int thread_count, int chunk_size, Function function)
+{
+    std::atomic<int> next(0);
+    auto work = [&]()
+    {
+        for (int begin = next.fetch_add(chunk_size); begin < count; begin = next.fetch_add(chunk_size))
+        {
+            function(begin, qMin(begin + chunk_size, count));
+        }
+    };
+
+    // no more threads than chunks
+    int threads_needed = qMin(thread_count, (count + chunk_size - 1) / chunk_size);
+    std::vector<std::thread> threads;
+    for (int i = 1; i < threads_needed; ++i)
+    {
+        threads.emplace_back(work);
+    }
+    work();
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+#endif // PARALLELFOR_H
@@ -0,0 +1,136 @@
+#include "perft.h"
+
+#include <QElapsedTimer>
+
+#include "shobuexception.h"
+
+enum PositionFormat
+{
+    FIELD_COUNT   = 64, // fields of the four boards, board by board, row by row
+    POSITION_SIZE = 65  // fields followed by the color to move
+};
+
+// PUBLIC
+
+// Constructor
+Perft::Perft(GameState *state) : _state(state)
+{
+}
+
+// returns the number of leaf nodes depth plies below the current state
+quint64 Perft::count(int depth)
+{
+    if (depth < 0)
+    {
+        QScopedPointer<ShobuException> exept_ptr(new ShobuException());
+        exept_ptr->setMessage("Perft depth can not be negative");
+        exept_ptr->raise();
+    }
+    Position position = _state->getPosition(); // count on a copy, the state is not touched
+    return countNodes(position, depth);
+}
+
+// returns the leaf node count below each root move
+QVector<PerftDivision> Perft::divide(int depth)
+{
+    QVector<PerftDivision> ret;
+    if (depth < 1 || _state->getVictor() != EMPTY)
+    {
+        return ret;
+    }
+
+    Position position = _state->getPosition(); // count on a copy, the state is not touched
+    MoveList moves;
+    position.getMoves(moves);
+    ret.reserve(moves.length());
+
+    for (int i = 0; i < moves.length(); ++i)
+    {
+        ReverseData reverse = position.applyUnchecked(moves[i]);
+        ret.push_back({moves[i], countNodes(position, depth - 1)});
+        position.reverseUnchecked(moves[i], reverse);
+    }
+    return ret;
+}
+
+// counts the leaf nodes and measures the time it took
+PerftResult Perft::run(int depth)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    quint64 nodes = count(depth);
+    return {depth, nodes, timer.elapsed()};
+}
+
+// sets up the state from 64 field characters ('w', 'b' or '.') and the color to move ('w' or 'b')
+bool Perft::loadPosition(GameState *state, const QString &position)
+{
+    if (position.length() != POSITION_SIZE)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < FIELD_COUNT; ++i)
+    {
+        QChar field = position[i].toLower();
+        if (field != 'w' && field != 'b' && field != '.')
+        {
+            return false;
+        }
+    }
+    QChar turn = position[FIELD_COUNT].toLower();
+    if (turn != 'w' && turn != 'b')
+    {
+        return false;
+    }
+
+    for (int i = 0; i < FIELD_COUNT; ++i)
+    {
+        QChar field = position[i].toLower();
+        Color color = field == 'w' ? WHITE : field == 'b' ? BLACK : EMPTY;
+        state->setField(i / 16, (i % 16) / 4, i % 4, color);
+    }
+    state->setTurn(turn == 'w' ? WHITE : BLACK);
+    return true;
+}
+
+// returns a readable form of a move: passive and agressive fields with the vector
+QString Perft::formatMove(Move move)
+{
+    return QString::number(move.p.board) + ":" + QString::number(move.p.row) + QString::number(move.p.column) + " "
+            + QString::number(move.a.board) + ":" + QString::number(move.a.row) + QString::number(move.a.column) + " "
+            + "(" + QString::number(move.row_change * move.magnitude) + "," + QString::number(move.col_change * move.magnitude) + ")";
+}
+
+// PRIVATE
+
+// recursive leaf count, won states above the horizon end their line without being counted
+quint64 Perft::countNodes(Position &position, int depth)
+{
+    if (depth == 0)
+    {
+        return 1;
+    }
+    if (position.getVictor() != EMPTY)
+    {
+        return 0;
+    }
+
+    MoveList moves;
+    position.getMoves(moves);
+    if (depth == 1) // bulk count the last ply
+    {
+        return moves.length();
+    }
+
+    quint64 nodes = 0;
+    for (int i = 0; i < moves.length(); ++i)
+    {
+        PackedMove move = moves[i];
+        ReverseData reverse = position.applyUnchecked(move);
+        nodes += countNodes(position, depth - 1);
+        position.reverseUnchecked(move, reverse);
+    }
+    return nodes;
+}
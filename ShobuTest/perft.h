@@ -0,0 +1,44 @@
+#ifndef PERFT_H
+#define PERFT_H
+
+#include <QString>
+#include <QVector>
+
+#include "gamestate.h"
+
+// leaf count of a single root move
+struct PerftDivision
+{
+    Move move;
+    quint64 nodes;
+};
+
+// result of a timed perft run
+struct PerftResult
+{
+    int depth;
+    quint64 nodes;
+    qint64 elapsed; // in milliseconds
+
+    quint64 nodesPerSecond() const {return elapsed > 0 ? nodes * 1000 / elapsed : nodes * 1000;}
+};
+
+class Perft
+{
+public:
+    Perft(GameState *state);
+
+    quint64 count(int depth);
+    QVector<PerftDivision> divide(int depth);
+    PerftResult run(int depth);
+
+    static bool loadPosition(GameState *state, const QString &position);
+    static QString formatMove(Move move);
+
+private:
+    GameState *_state;
+
+    static quint64 countNodes(Position &position, int depth);
+};
+
+#endif // PERFT_H
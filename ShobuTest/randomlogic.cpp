@@ -9,7 +9,8 @@
 // returns a random move
 Move RandomLogic::getMove()
 {
-    QVector<Move> moves = _state->getMoves();
+    MoveList moves;
+    _state->getMoves(moves);
 
     if (moves.isEmpty()) // can not return a legal move when there are no legal moves
     {
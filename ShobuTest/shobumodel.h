@@ -77,6 +77,7 @@ private:
     int getStepSize();
     void applySettings();
     void applyMove();
+    void cancelMove();
 
     // Network
     void onGameStarted(GameSettings settings);
@@ -17,6 +17,8 @@ public:
     virtual void makeMove(int, int, int){};
     virtual void makeMove(Move) = 0;
     virtual void makeMove() = 0;
+    virtual void cancelMove(){}; // drops the move in progress, moveMade is not emitted for it
+    virtual void ponder(){};     // called after our move, the other player is to move
 
 protected:
     MoveState *state;
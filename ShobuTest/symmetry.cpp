@@ -0,0 +1,220 @@
+#include "symmetry.h"
+
+// images of the bytes of a mask under each field transformation, indexed by transformation, byte and value
+struct MaskTable
+{
+    quint16 masks[8][2][256];
+};
+
+// transforms a field: transpose first (bit 2), then mirror the rows (bit 1) and the columns (bit 0)
+static constexpr int fieldImage(int transform, int field)
+{
+    int row = field/4;
+    int column = field%4;
+    if (transform & 4)
+    {
+        int swap = row;
+        row = column;
+        column = swap;
+    }
+    if (transform & 2)
+    {
+        row = 3 - row;
+    }
+    if (transform & 1)
+    {
+        column = 3 - column;
+    }
+    return row*4 + column;
+}
+
+// builds the byte images of every field transformation
+static constexpr MaskTable generateMasks()
+{
+    MaskTable table{};
+    for (int transform = 0; transform < 8; ++transform)
+    {
+        for (int half = 0; half < 2; ++half)
+        {
+            for (int value = 0; value < 256; ++value)
+            {
+                quint16 mask = 0;
+                for (int bit = 0; bit < 8; ++bit)
+                {
+                    if (value & (1 << bit))
+                    {
+                        mask |= 1 << fieldImage(transform, half*8 + bit);
+                    }
+                }
+                table.masks[transform][half][value] = mask;
+            }
+        }
+    }
+    return table;
+}
+
+static constexpr MaskTable MASKS = generateMasks();
+
+// PUBLIC
+
+// returns the symmetry that undoes this one
+Symmetry Symmetry::inverse() const
+{
+    int transform = _id & 7;
+    if (transform & 4) // mirroring after a transpose is a transpose after the other mirror
+    {
+        transform = 4 | (transform & 1) << 1 | (transform & 2) >> 1;
+    }
+    return Symmetry((_id & ~7) | transform);
+}
+
+// returns the transformed position with the same Zobrist key as if it was set up by hand
+Position Symmetry::apply(const Position &position) const
+{
+    Position ret = position;
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int color = 0; color < 2; ++color)
+        {
+            int new_color = swapsColors() ? 1 - color : color;
+            ret._pieces[transformBoard(i)][new_color] = transformMask(position._pieces[i][color]);
+        }
+    }
+    if (swapsColors())
+    {
+        ret._turn = position.getOpponent();
+    }
+    ret._hash = ret.computeHash();
+    return ret;
+}
+
+// returns the move that does the same in the transformed position
+PackedMove Symmetry::apply(PackedMove move) const
+{
+    return PackedMove(transformBoard(move.passiveBoard()), transformField(move.passiveField()),
+                      transformBoard(move.agressiveBoard()), transformField(move.agressiveField()),
+                      transformDirection(move.direction()), move.magnitude());
+}
+
+// finds the smallest transformed position, returns the symmetry that maps the position to it
+Symmetry Symmetry::canonicalize(const Position &position, Position &canonical)
+{
+    Symmetry ret;
+    canonical = position;
+
+    for (int i = 1; i < COUNT; ++i)
+    {
+        Symmetry symmetry(i);
+        Position transformed = symmetry.apply(position);
+        if (isLess(transformed, canonical))
+        {
+            canonical = transformed;
+            ret = symmetry;
+        }
+    }
+    return ret;
+}
+
+// returns the smallest transformed position, the same for every symmetric position
+Position Symmetry::getCanonical(const Position &position)
+{
+    Position ret;
+    canonicalize(position, ret);
+    return ret;
+}
+
+// gets the moves of getMoves, keeping one of the moves whose resulting positions a symmetry of the position maps onto each other
+int Symmetry::getUniqueMoves(const Position &position, MoveList &moves)
+{
+    position.getMoves(moves); // no two of these give the same position
+
+    // a symmetry keeping the position maps each resulting position to another resulting position
+    Symmetry keeping[COUNT];
+    int keeping_count = 0;
+    for (int i = 1; i < COUNT; ++i)
+    {
+        Symmetry symmetry(i);
+        if (symmetry.apply(position) == position)
+        {
+            keeping[keeping_count++] = symmetry;
+        }
+    }
+    if (!keeping_count) // most positions have no symmetry
+    {
+        return 0;
+    }
+
+    // keep the move whose resulting position has the smallest key in its class
+    int length = 0;
+    for (int i = 0; i < moves.length(); ++i)
+    {
+        Position result = position;
+        result.applyUnchecked(moves[i]);
+        bool smallest = true;
+        for (int j = 0; j < keeping_count && smallest; ++j)
+        {
+            smallest = keeping[j].apply(result).hash() >= result.hash();
+        }
+        if (smallest)
+        {
+            moves[length++] = moves[i];
+        }
+    }
+
+    int removed = moves.length() - length;
+    moves.truncate(length);
+    return removed;
+}
+
+// PRIVATE
+
+// transforms a field index of a board
+int Symmetry::transformField(int field) const
+{
+    return fieldImage(_id & 7, field);
+}
+
+// transforms a direction the same way as the fields
+int Symmetry::transformDirection(int direction) const
+{
+    // a vector is transformed like the fields, without the shift of the mirrors
+    int row_change = PackedMove::rowChange(direction);
+    int col_change = PackedMove::colChange(direction);
+    if (_id & 4)
+    {
+        int swap = row_change;
+        row_change = col_change;
+        col_change = swap;
+    }
+    if (_id & 2)
+    {
+        row_change = -row_change;
+    }
+    if (_id & 1)
+    {
+        col_change = -col_change;
+    }
+    return PackedMove::toDirection(row_change, col_change);
+}
+
+// transforms every field of a mask
+quint16 Symmetry::transformMask(quint16 mask) const
+{
+    return MASKS.masks[_id & 7][0][mask & 0xFF] | MASKS.masks[_id & 7][1][mask >> 8];
+}
+
+// orders positions by their masks board by board, then by the turn
+bool Symmetry::isLess(const Position &first, const Position &second)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int color = 0; color < 2; ++color)
+        {
+            if (first._pieces[i][color] != second._pieces[i][color])
+            {
+                return first._pieces[i][color] < second._pieces[i][color];
+            }
+        }
+    }
+    return first._turn < second._turn;
+}
@@ -0,0 +1,70 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <QtGlobal>
+#include <QScopedPointer>
+
+#include <atomic>
+
+#include "position.h"
+
+// Kind of the stored score compared to the real score of the position
+enum Bound
+{
+    NO_BOUND    = 0,
+    UPPER_BOUND = 1, // every move failed low, the real score is at most this
+    LOWER_BOUND = 2, // a move failed high, the real score is at least this
+    EXACT_BOUND = 3
+};
+
+// One position of the TranspositionTable, unpacked
+struct TranspositionEntry
+{
+    int score;
+    int depth;
+    Bound bound;
+    PackedMove move; // best or refuting move, PackedMove(0) if there was none
+};
+
+// Search results keyed by the Zobrist key of the positions, in buckets of four entries in 64 bytes,
+// probe and store can be called from several threads without a lock
+class TranspositionTable
+{
+public:
+    enum { DEFAULT_SIZE = 16 }; // in megabytes
+
+    TranspositionTable(int megabytes = DEFAULT_SIZE);
+
+    void resize(int megabytes); // rounded down to a power of two buckets, clears the table
+    int getSize() const {return static_cast<int>((_mask + 1) * sizeof(Bucket) >> 20);}
+    void clear();
+    void newSearch() {_age = (_age + 1) & AGE_MASK;} // older entries are replaced first
+
+    bool probe(quint64 key, TranspositionEntry &entry) const;
+    void store(quint64 key, int depth, Bound bound, int score, PackedMove move);
+
+private:
+    enum
+    {
+        BUCKET_SIZE = 4,
+        AGE_MASK    = 63
+    };
+
+    // each entry is the key xor the data and the data, a torn entry does not match its key,
+    // a bucket fills one cache line, new[] aligns it since C++17
+    struct alignas(64) Bucket
+    {
+        std::atomic<quint64> entries[BUCKET_SIZE][2];
+    };
+    static_assert(sizeof(Bucket) == 64, "Bucket should fill one cache line");
+
+    QScopedArrayPointer<Bucket> _buckets;
+    quint64 _mask; // bucket index of a key, the number of buckets minus one
+    int _age;
+
+    static quint64 pack(int depth, Bound bound, int score, PackedMove move, int age);
+    static int packedDepth(quint64 data) {return static_cast<int>(data >> 48 & 0xFF);}
+    static int packedAge(quint64 data) {return static_cast<int>(data >> 58);}
+};
+
+#endif // TRANSPOSITIONTABLE_H
@@ -4,12 +4,20 @@
 #include "randomlogic.h"
 #include "greedylogic.h"
 #include "hardlogic.h"
+#include "searchlogic.h"
+#include "montecarlologic.h"
 #include "organicplayer.h"
 #include "machineplayer.h"
 #include "shobumodel.h"
 #include "gamestate.h"
 #include "shobuexception.h"
+#include "perft.h"
+#include "symmetry.h"
+#include "batchevaluator.h"
+#include "parallelfor.h"
 #include <QDebug>
+#include <algorithm>
+#include <thread>
 
 class ShobuTest : public QObject // test environment
 {
@@ -39,12 +47,31 @@ private slots:
     void is_legal_vector();
     void is_legal_agressive();
     void get_moves();
+    void has_moves();
+    void staged_moves();
+    void push_moves();
     void get_passive_pieces();
     void get_destinations();
     void get_agressive_pieces();
+    void move_index();
     void get_applied();
     void apply_move();
     void reverse_move();
+    void apply_unchecked();
+    void undo_stack();
+    void get_piece_count();
+    void packed_move();
+    void position_value();
+    void position_hash();
+    void position_symmetry();
+    void unique_moves();
+    void batch_evaluator();
+    void parallel_for();
+
+    // Perft functions
+    void perft_count();
+    void perft_divide();
+    void perft_position();
 
     // GameLogic children
     void random_legal();
@@ -53,11 +80,25 @@ private slots:
     void greedy_beats_random();
     void hard_beats_random();
     void hard_beats_greedy();
+    void parallel_logics();
+    void search_legal();
+    void search_budget();
+    void search_finds_win();
+    void search_threads();
+    void search_ponder();
+    void transposition_table();
+    void monte_carlo_legal();
+    void monte_carlo_budget();
+    void monte_carlo_finds_win();
+    void monte_carlo_reuse();
     void machine_logic_error();
 
     // ShobuPlayer children
     void organic_moves();
     void machine_moves();
+    void machine_async();
+    void machine_ponder();
+    void machine_monte_carlo();
 
     // ShobuModel functions
     void set_settings();
@@ -79,11 +120,17 @@ private:
     RandomLogic *_random;
     GreedyLogic *_greedy;
     HardLogic *_hard_white, *_hard_black;
+    SearchLogic *_search;
+    MonteCarloLogic *_monte_carlo;
 
     MachinePlayer *_machine_white, *_machine_black;
     OrganicPlayer *_organic;
 
     ShobuModel *_model;
+
+    // Helpers
+    void randomizePosition(QRandomGenerator &generator);
+    void setWinningPushPosition();
 };
 
 void ShobuTest::init() // create everything
@@ -99,6 +146,8 @@ void ShobuTest::init() // create everything
     _greedy = new GreedyLogic(_state, this);
     _hard_black = new HardLogic(_state, BLACK, this);
     _hard_white = new HardLogic(_state, WHITE, this);
+    _search = new SearchLogic(_state, this);
+    _monte_carlo = new MonteCarloLogic(_state, this);
 
     _machine_white = new MachinePlayer(&_move, WHITE, MEDIUM, this);
     _machine_black = new MachinePlayer(&_move, BLACK, MEDIUM, this);
@@ -114,12 +163,44 @@ void ShobuTest::cleanup() // destroy everything
     delete _greedy;
     delete _hard_black;
     delete _hard_white;
+    delete _search;
+    delete _monte_carlo;
     delete _machine_white;
     delete _machine_black;
     delete _organic;
     delete _model;
 }
 
+// Helpers
+
+// puts a random piece or nothing on every field and gives the turn to a random player
+void ShobuTest::randomizePosition(QRandomGenerator &generator)
+{
+    for (int j = 0; j < 64; ++j)
+    {
+        _state->setField(j/16, (j%16)/4, j%4, static_cast<Color>(generator.bounded(3)));
+    }
+    _state->setTurn(static_cast<Color>(generator.bounded(2)));
+}
+
+// white can push the last black piece off board 0
+void ShobuTest::setWinningPushPosition()
+{
+    for (int i = 0; i < 64; ++i)
+    {
+        _state->setField(i/16, (i%16)/4, i%4, EMPTY);
+    }
+    _state->setField(0,1,1,WHITE);
+    _state->setField(0,0,1,BLACK);
+    _state->setField(1,3,3,WHITE);
+    _state->setField(1,0,0,BLACK);
+    _state->setField(2,3,0,WHITE);
+    _state->setField(2,0,3,BLACK);
+    _state->setField(3,3,1,WHITE);
+    _state->setField(3,0,0,BLACK);
+    _state->setTurn(WHITE);
+}
+
 // GameState functions
 
 // checks the GameState::initializeGame function when the state is empty
@@ -662,6 +743,127 @@ void ShobuTest::get_moves()
     {
         QVERIFY2(_state->isLegalMove(moves[i]), "The function returned an illegal move");
     }
+
+    MoveList list;
+    _state->getMoves(list);
+
+    QVERIFY2(list.length() == moves.length(), "The move list and the vector differ in length");
+    for (int i = 0; i < list.length(); ++i) // the move list is filled in the same order
+    {
+        QVERIFY2(list[i] == PackedMove(moves[i]), "The move list does not match the vector");
+    }
+}
+
+// checks the GameState::hasMoves function against the move generator
+void ShobuTest::has_moves()
+{
+    QVERIFY2(_state->hasMoves(), "Starting state has no moves");
+
+    // pieces stuck in the corners of the homeboards have no passive move
+    for (int i = 0; i < 64; ++i)
+    {
+        _state->setField(i/16, (i%16)/4, i%4, EMPTY);
+    }
+    _state->setField(2,3,0,WHITE);
+    _state->setField(2,2,0,BLACK);
+    _state->setField(2,2,1,BLACK);
+    _state->setField(2,3,1,BLACK);
+    _state->setField(3,0,0,WHITE);
+    _state->setField(3,0,1,BLACK);
+    _state->setField(3,1,0,BLACK);
+    _state->setField(3,1,1,BLACK);
+    _state->setField(1,0,0,WHITE);
+    _state->setField(0,0,0,WHITE);
+    _state->setTurn(WHITE);
+    QVERIFY2(!_state->hasMoves() && _state->getMoves().isEmpty(), "Blocked pieces have moves");
+
+    // random positions agree with the move generator
+    QRandomGenerator generator(42);
+    for (int i = 0; i < 2000; ++i)
+    {
+        randomizePosition(generator);
+        QVERIFY2(_state->hasMoves() == !_state->getMoves().isEmpty(), "hasMoves does not match the generated moves");
+    }
+}
+
+// checks that StagedMoves gives every legal move once, stage by stage
+void ShobuTest::staged_moves()
+{
+    QRandomGenerator generator(7);
+    for (int i = 0; i < 2000; ++i)
+    {
+        randomizePosition(generator);
+        Position position = _state->getPosition();
+        if (position.getVictor() != EMPTY) // only running games
+        {
+            continue;
+        }
+
+        MoveList all;
+        position.getMoves(all);
+
+        // every stage holds what it promises, stages come in order
+        StagedMoves staged(position);
+        PackedMove move;
+        int count = 0;
+        int last_stage = WINNING_PUSHES;
+        while (staged.next(move))
+        {
+            QVERIFY2(staged.getStage() >= last_stage, "Stages are out of order");
+            last_stage = staged.getStage();
+            QVERIFY2(std::find(all.begin(), all.end(), move) != all.end(), "Staged move is not generated by getMoves");
+            ++count;
+
+            Color mover = position.getTurn();
+            Position applied = position;
+            ReverseData reverse = applied.applyUnchecked(move);
+            switch (staged.getStage())
+            {
+            case WINNING_PUSHES:
+                QVERIFY2(applied.getVictor() == mover, "Winning push does not win");
+                break;
+            case PUSHES:
+                QVERIFY2(reverse.has_push && applied.getVictor() == EMPTY, "Push stage holds a quiet or winning move");
+                break;
+            default:
+                QVERIFY2(!reverse.has_push, "Quiet move pushes");
+                break;
+            }
+        }
+        QVERIFY2(count == all.length(), "Staged moves differ from getMoves");
+        QVERIFY2(!staged.next(move), "Finished stages give more moves");
+    }
+}
+
+// checks the GameState::getPushes and GameState::getPushOffs functions against the full generation
+void ShobuTest::push_moves()
+{
+    QRandomGenerator generator(11);
+    for (int i = 0; i < 2000; ++i)
+    {
+        randomizePosition(generator);
+
+        MoveList all, pushes, push_offs;
+        _state->getMoves(all);
+        _state->getPushes(pushes);
+        _state->getPushOffs(push_offs);
+
+        // filter the full generation by the result of each move
+        int push_count = 0;
+        int push_off_count = 0;
+        for (PackedMove move : all)
+        {
+            Position position = _state->getPosition();
+            ReverseData reverse = position.applyUnchecked(move);
+            bool in_pushes = std::find(pushes.begin(), pushes.end(), move) != pushes.end();
+            bool in_push_offs = std::find(push_offs.begin(), push_offs.end(), move) != push_offs.end();
+            QVERIFY2(in_pushes == reverse.has_push, "Pushes differ from the pushing moves");
+            QVERIFY2(in_push_offs == (reverse.has_push && !reverse.on_board), "Push offs differ from the moves pushing off");
+            push_count += reverse.has_push;
+            push_off_count += reverse.has_push && !reverse.on_board;
+        }
+        QVERIFY2(pushes.length() == push_count && push_offs.length() == push_off_count, "Push generators give extra moves");
+    }
 }
 
 // checks the GameState::getPassivePieces function
@@ -745,6 +947,62 @@ void ShobuTest::get_agressive_pieces()
     }
 }
 
+// checks the MoveIndex of positions against every combination of legal move parts
+void ShobuTest::move_index()
+{
+    QRandomGenerator generator(7);
+    for (int n = 0; n < 20; ++n)
+    {
+        MoveIndex index = _state->getPosition().getMoveIndex();
+
+        for (int p = 0; p < 64; ++p)
+        {
+            Coordinate passive(p/16, (p%16)/4, p%4);
+            bool has_move = false;
+
+            for (int v = 0; v < 16; ++v)
+            {
+                int row_change = PackedMove::rowChange(v/2), col_change = PackedMove::colChange(v/2), magnitude = v%2 + 1;
+                bool has_agressive = false;
+
+                for (int a = 0; a < 64; ++a)
+                {
+                    Coordinate agressive(a/16, (a%16)/4, a%4);
+                    bool legal = _state->isLegalMove(Move(passive, agressive, row_change, col_change, magnitude));
+                    bool indexed = (index.getVectorMask(passive.board, p%16) & (1 << v)) && (index.getAgressiveMask(agressive.board, v) & (1 << a%16))
+                            && passive.board%2 != agressive.board%2;
+                    QVERIFY2(legal == indexed, "MoveIndex does not match the legal moves");
+                    has_agressive = has_agressive || legal;
+                }
+                QVERIFY2(has_agressive == bool(index.getVectorMask(passive.board, p%16) & (1 << v)), "MoveIndex has a vector without a legal move");
+                has_move = has_move || has_agressive;
+            }
+            QVERIFY2(has_move == bool(index.getPassiveMask(passive.board) & (1 << p%16)), "MoveIndex passive pieces do not match the legal moves");
+        }
+
+        // the cached index of GameState follows the moves
+        QVector<Coordinate> passives;
+        for (int i = 0; i < 4; ++i)
+        {
+            passives += _state->getPassivePieces(i);
+        }
+        int count = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            count += qPopulationCount(index.getPassiveMask(i));
+        }
+        QVERIFY2(passives.length() == count, "GameState answered from an outdated MoveIndex");
+
+        MoveList moves;
+        _state->getMoves(moves);
+        if (moves.isEmpty() || _state->getVictor() != EMPTY)
+        {
+            break;
+        }
+        _state->push(moves[generator.bounded(moves.length())]);
+    }
+}
+
 // checks the GameState::getApplied function
 void ShobuTest::get_applied()
 {
@@ -753,7 +1011,7 @@ void ShobuTest::get_applied()
     for (int i  = 0; i < moves.length(); ++i)
     {
         GameState *applied = _state->getApplied(moves[i]);
-        ReverseData reverse = _state->applyMove(moves[i]);
+        _state->push(moves[i]);
 
         QVERIFY2(_state->getTurn() == applied->getTurn(), "The returned GameState's turn does not match the normally applied one");
 
@@ -769,11 +1027,11 @@ void ShobuTest::get_applied()
         }
 
         delete applied;
-        _state->reverseMove(moves[i], reverse);
+        _state->pop();
     }
 }
 
-// checks the GameState::applyMove function
+// checks applying moves with the GameState::push function
 void ShobuTest::apply_move()
 {
     Move move;
@@ -785,7 +1043,7 @@ void ShobuTest::apply_move()
     move.magnitude  = 1;
     move.a          = Coordinate(1,3,2);
 
-    _state->applyMove(move);
+    _state->push(move);
 
     // step successful
     QVERIFY2(_state->getField(2,3,1) == EMPTY, "Passive failed to leave at first step");
@@ -801,7 +1059,7 @@ void ShobuTest::apply_move()
     move.magnitude  = 2;
     move.a          = Coordinate(1,0,1);
 
-    _state->applyMove(move);
+    _state->push(move);
 
     // step successful
     QVERIFY2(_state->getField(0,0,0) == EMPTY, "Passive failed to leave at second step");
@@ -817,7 +1075,7 @@ void ShobuTest::apply_move()
     move.magnitude  = 2;
     move.a          = Coordinate(1,3,3);
 
-    QVERIFY_EXCEPTION_THROWN(_state->applyMove(move), ShobuException);
+    QVERIFY_EXCEPTION_THROWN(_state->push(move), ShobuException);
 
     // Push step
     move.p          = Coordinate(2,3,0);
@@ -826,7 +1084,7 @@ void ShobuTest::apply_move()
     move.magnitude  = 1;
     move.a          = Coordinate(1,3,3);
 
-    _state->applyMove(move);
+    _state->push(move);
 
     // step successful
     QVERIFY2(_state->getField(2,3,0) == EMPTY, "Passive failed to leave at third step");
@@ -837,7 +1095,7 @@ void ShobuTest::apply_move()
     QVERIFY2(_state->getTurn()       == BLACK, "Third step failed to end its turn");
 }
 
-// checks the GameState::reverseMove function
+// checks reversing moves with the GameState::pop function
 void ShobuTest::reverse_move()
 {
     QVector<Move> moves = _state->getMoves();
@@ -846,8 +1104,8 @@ void ShobuTest::reverse_move()
     {
         GameState *applied = new GameState(this);
         applied->setState(_state);
-        ReverseData reverse = applied->applyMove(moves[i]);
-        applied->reverseMove(moves[i], reverse);
+        applied->push(moves[i]);
+        applied->pop();
 
         QVERIFY2(_state->getTurn() == applied->getTurn(), "The turn did not change back to the previous color");
 
@@ -865,6 +1123,461 @@ void ShobuTest::reverse_move()
     }
 }
 
+// checks the Position::applyUnchecked and Position::reverseUnchecked functions
+void ShobuTest::apply_unchecked()
+{
+    MoveList moves;
+    _state->getMoves(moves);
+
+    for (int i = 0; i < moves.length(); ++i)
+    {
+        Position checked = _state->getPosition();
+        checked.applyMove(moves[i]);
+
+        Position unchecked = _state->getPosition();
+        ReverseData reverse = unchecked.applyUnchecked(moves[i]);
+
+        QVERIFY2(checked.getTurn() == unchecked.getTurn(), "Unchecked step ended its turn differently");
+        for (int j = 0; j < 4; ++j)
+        {
+            QVERIFY2(checked.getPieceMask(j, WHITE) == unchecked.getPieceMask(j, WHITE) && checked.getPieceMask(j, BLACK) == unchecked.getPieceMask(j, BLACK),
+                     "Unchecked step left the boards differently than the checked one");
+            QVERIFY2(checked.getPieceCount(j, WHITE) == unchecked.getPieceCount(j, WHITE) && checked.getPieceCount(j, BLACK) == unchecked.getPieceCount(j, BLACK),
+                     "Unchecked step counted the pieces differently than the checked one");
+        }
+
+        unchecked.reverseUnchecked(moves[i], reverse);
+
+        QVERIFY2(_state->getTurn() == unchecked.getTurn(), "The turn did not change back to the previous color");
+        for (int j = 0; j < 4; ++j)
+        {
+            QVERIFY2(_state->getPieceMask(j, WHITE) == unchecked.getPieceMask(j, WHITE) && _state->getPieceMask(j, BLACK) == unchecked.getPieceMask(j, BLACK),
+                     "One of the boards does not match the previous state after reversing");
+        }
+    }
+}
+
+// checks the GameState::push and GameState::pop functions and the history they keep
+void ShobuTest::undo_stack()
+{
+    QVERIFY_EXCEPTION_THROWN(_state->pop(), ShobuException);
+
+    // play random moves, then undo them one by one
+    QRandomGenerator generator(5);
+    QVector<Position> played;
+    while (played.length() < 60 && _state->getVictor() == EMPTY && _state->hasMoves())
+    {
+        played.append(_state->getPosition());
+        QVector<Move> moves = _state->getMoves();
+        _state->push(moves[generator.bounded(moves.length())]);
+    }
+    QVERIFY2(_state->getHistoryLength() == played.length(), "History length differs from the pushed moves");
+    while (!played.isEmpty())
+    {
+        _state->pop();
+        QVERIFY2(_state->getPosition() == played.last() && _state->hash() == played.last().hash(), "Pop does not restore the position");
+        played.pop_back();
+    }
+    QVERIFY2(_state->getHistoryLength() == 0, "History is not empty after undoing every move");
+
+    // moves from empty fields change neither the position nor the history
+    Position start = _state->getPosition();
+    QVERIFY_EXCEPTION_THROWN(_state->push(Move(Coordinate(0,1,1), Coordinate(1,1,1), 1, 0, 1)), ShobuException);
+    QVERIFY2(_state->getPosition() == start && _state->getHistoryLength() == 0, "Illegal push changed the state");
+
+    // replacing the position clears the history
+    _state->makeMove(_state->getMoves()[0]);
+    QVERIFY2(_state->getHistoryLength() == 1, "makeMove is not recorded");
+    _state->setTurn(_state->getTurn());
+    QVERIFY2(_state->getHistoryLength() == 0, "Setters keep the history");
+}
+
+// checks the GameState::getPieceMask and GameState::getPieceCount functions
+void ShobuTest::get_piece_count()
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        QVERIFY2(_state->getPieceMask(i, BLACK) == 0x000F, "Black pieces are not on the first row of the mask");
+        QVERIFY2(_state->getPieceMask(i, WHITE) == 0xF000, "White pieces are not on the last row of the mask");
+        QVERIFY2(_state->getPieceCount(i, BLACK) == 4, "Black does not start with four pieces on a board");
+        QVERIFY2(_state->getPieceCount(i, WHITE) == 4, "White does not start with four pieces on a board");
+    }
+
+    _state->setField(1,0,2,EMPTY);
+    _state->setField(1,2,1,BLACK);
+    _state->setField(3,3,0,BLACK);
+
+    QVERIFY2(_state->getPieceMask(1, BLACK) == 0x020B, "Black mask does not follow the changed fields");
+    QVERIFY2(_state->getPieceCount(1, BLACK) == 4, "Moving a piece changed the piece count");
+    QVERIFY2(_state->getPieceMask(3, WHITE) == 0xE000, "Overwritten white piece remained in the mask");
+    QVERIFY2(_state->getPieceCount(3, WHITE) == 3, "Overwritten white piece is still counted");
+    QVERIFY2(_state->getPieceCount(3, BLACK) == 5, "New black piece is not counted");
+
+    // counts follow pushes off the board and their reversal
+    _state->initializeGame();
+    Move move(Coordinate(2,3,1), Coordinate(1,3,2), -1, 1, 1);
+    _state->push(move);
+    move = Move(Coordinate(0,0,0), Coordinate(1,0,1), 1, 1, 2);
+    _state->push(move);
+
+    QVERIFY2(_state->getPieceCount(1, WHITE) == 3, "Piece pushed off the board is still counted");
+    QVERIFY2(_state->getPieceCount(1, BLACK) == 4, "Pushing changed the count of the pusher");
+
+    GameState copy;
+    copy.setState(_state);
+    QVERIFY2(copy.getPieceCount(1, WHITE) == 3, "Copied state has different counts");
+
+    _state->pop();
+    QVERIFY2(_state->getPieceCount(1, WHITE) == 4, "Reversed push off is not counted again");
+
+    // victory follows the counts
+    for (int i = 0; i < 4; ++i)
+    {
+        _state->setField(3,3,i,EMPTY);
+    }
+    QVERIFY2(_state->getPieceCount(3, WHITE) == 0, "Emptied board still has white pieces");
+    QVERIFY2(_state->getVictor() == BLACK, "Emptied board does not end the game");
+}
+
+// checks the conversions of PackedMove
+void ShobuTest::packed_move()
+{
+    QVector<Move> moves = _state->getMoves();
+
+    for (int i = 0; i < moves.length(); ++i) // every generated move survives packing
+    {
+        Move move = PackedMove(moves[i]).toMove();
+        QVERIFY2(move.p == moves[i].p && move.a == moves[i].a, "Packing changed the pieces of a move");
+        QVERIFY2(move.row_change == moves[i].row_change && move.col_change == moves[i].col_change && move.magnitude == moves[i].magnitude,
+                 "Packing changed the vector of a move");
+    }
+
+    for (int i = 0; i <= 0xFFFF; ++i) // every packed value is a move with valid ranges
+    {
+        PackedMove packed(static_cast<quint16>(i));
+        Move move = packed;
+
+        QVERIFY2(move.magnitude == 1 || move.magnitude == 2, "Unpacked magnitude is out of range");
+        QVERIFY2(move.row_change != 0 || move.col_change != 0, "Unpacked vector has no direction");
+        QVERIFY2(PackedMove(move) == packed, "Unpacking and packing again changed the move");
+    }
+}
+
+// checks that Position is copied by value and GameState follows it
+void ShobuTest::position_value()
+{
+    Position start = _state->getPosition();
+    Move move(Coordinate(2,3,1), Coordinate(1,3,2), -1, 1, 1);
+
+    Position applied = start.getApplied(move);
+    QVERIFY2(start == _state->getPosition(), "Applying on a copy changed the original position");
+    QVERIFY2(applied != start, "Applied position equals the original one");
+    QVERIFY2(applied.getField(2,2,2) == WHITE && applied.getTurn() == BLACK, "Applied position does not contain the move");
+
+    Position copy = applied; // plain copy, no parent or allocation needed
+    QVERIFY2(copy == applied, "Copied position differs from its source");
+
+    _state->setPosition(applied);
+    QVERIFY2(_state->getField(2,2,2) == WHITE && _state->getTurn() == BLACK, "GameState does not show the set position");
+
+    GameState other;
+    other.setState(_state);
+    QVERIFY2(other.getPosition() == applied, "Copied GameState has a different position");
+
+    _state->setPosition(start);
+    QVERIFY2(_state->getField(2,3,1) == WHITE && _state->getTurn() == WHITE, "GameState did not go back to the original position");
+}
+
+// checks the incremental Zobrist key of the positions
+void ShobuTest::position_hash()
+{
+    quint64 start = _state->hash();
+
+    // the key follows every generated move and its reversal
+    MoveList moves;
+    _state->getMoves(moves);
+    for (int i = 0; i < moves.length(); ++i)
+    {
+        _state->push(moves[i]);
+
+        GameState rebuilt; // same position built field by field
+        rebuilt.initializeGame();
+        for (int j = 0; j < 64; ++j)
+        {
+            rebuilt.setField(j/16, (j%16)/4, j%4, _state->getField(j/16, (j%16)/4, j%4));
+        }
+        rebuilt.setTurn(_state->getTurn());
+        QVERIFY2(rebuilt.hash() == _state->hash(), "Incremental key differs from the key of the same position");
+        QVERIFY2(_state->hash() != start, "Move did not change the key");
+
+        _state->pop();
+        QVERIFY2(_state->hash() == start, "Reversing did not restore the key");
+    }
+
+    // pushes off and on the board are part of the key
+    Move move(Coordinate(2,3,1), Coordinate(1,3,2), -1, 1, 1);
+    _state->push(move);
+    quint64 before_push = _state->hash();
+    move = Move(Coordinate(0,0,0), Coordinate(1,0,1), 1, 1, 2);
+    _state->push(move);
+    QVERIFY2(_state->getPieceCount(1, WHITE) == 3, "Test move is not a push off the board");
+    _state->pop();
+    QVERIFY2(_state->hash() == before_push, "Reversing a push did not restore the key");
+
+    // the side to move is part of the key
+    Color turn = _state->getTurn();
+    quint64 key = _state->hash();
+    _state->endTurn();
+    QVERIFY2(_state->hash() != key, "Turn is not part of the key");
+    _state->setTurn(turn);
+    QVERIFY2(_state->hash() == key, "Setting the turn back did not restore the key");
+}
+
+// checks the symmetric transformations of positions and moves
+void ShobuTest::position_symmetry()
+{
+    QRandomGenerator generator(3);
+    for (int n = 0; n < 10; ++n)
+    {
+        Position position = _state->getPosition();
+        Position canonical;
+        Symmetry to_canonical = Symmetry::canonicalize(position, canonical);
+
+        QVERIFY2(to_canonical.apply(position) == canonical, "Returned symmetry does not lead to the canonical position");
+        QVERIFY2(to_canonical.inverse().apply(canonical) == position, "Inverse symmetry does not lead back to the position");
+
+        MoveList moves;
+        position.getMoves(moves);
+        GameState transformed_state;
+
+        for (int i = 0; i < Symmetry::COUNT; ++i)
+        {
+            Symmetry symmetry(i);
+            Position transformed = symmetry.apply(position);
+
+            QVERIFY2(Symmetry::getCanonical(transformed) == canonical, "Symmetric positions have different canonical positions");
+            QVERIFY2(Symmetry::canonicalHash(transformed) == canonical.hash(), "Symmetric positions have different canonical keys");
+
+            // the same moves are legal in the transformed position
+            for (PackedMove move : moves)
+            {
+                PackedMove image = symmetry.apply(move);
+                QVERIFY2(transformed.isLegalMove(image), "Transformed move is illegal in the transformed position");
+                QVERIFY2(symmetry.inverse().apply(image) == move, "Inverse symmetry does not give back the move");
+            }
+            transformed_state.setPosition(transformed);
+            Perft perft(&transformed_state);
+            QVERIFY2(perft.count(2) == Perft(_state).count(2), "Transformed position has a different move tree");
+        }
+
+        if (moves.isEmpty() || _state->getVictor() != EMPTY)
+        {
+            break;
+        }
+        _state->push(moves[generator.bounded(moves.length())]);
+    }
+}
+
+// checks the Symmetry::getUniqueMoves function
+void ShobuTest::unique_moves()
+{
+    QRandomGenerator generator(9);
+    for (int n = 0; n < 10; ++n)
+    {
+        Position position = _state->getPosition();
+        MoveList all, unique;
+        position.getMoves(all);
+        int removed = Symmetry::getUniqueMoves(position, unique);
+        QVERIFY2(unique.length() + removed == all.length(), "Removed count does not match");
+        if (n == 0)
+        {
+            QVERIFY2(removed > 0, "Symmetric starting position has no removed moves");
+        }
+
+        // the kept moves reach every resulting position up to symmetry, each only once
+        QVector<quint64> all_keys, unique_keys;
+        for (PackedMove move : all)
+        {
+            Position child = position;
+            child.applyUnchecked(move);
+            quint64 key = Symmetry::canonicalHash(child);
+            if (!all_keys.contains(key))
+            {
+                all_keys.append(key);
+            }
+        }
+        for (PackedMove move : unique)
+        {
+            Position child = position;
+            child.applyUnchecked(move);
+            quint64 key = Symmetry::canonicalHash(child);
+            QVERIFY2(std::find(all.begin(), all.end(), move) != all.end(), "Unique move is not generated by getMoves");
+            QVERIFY2(!unique_keys.contains(key), "Unique moves give symmetric positions");
+            unique_keys.append(key);
+        }
+        QVERIFY2(unique_keys.length() == all_keys.length(), "Unique moves miss a resulting position");
+
+        if (all.isEmpty() || _state->getVictor() != EMPTY)
+        {
+            break;
+        }
+        _state->push(all[generator.bounded(all.length())]);
+    }
+}
+
+// checks every kernel of the BatchEvaluator against the pieces of the positions
+void ShobuTest::batch_evaluator()
+{
+    BatchEvaluator evaluator;
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int field = 0; field < 16; ++field)
+        {
+            evaluator.setWeight(i, WHITE, field, i*100 + field);
+            evaluator.setWeight(i, BLACK, field, -(i*10 + field*3));
+        }
+    }
+
+    // random positions, an odd number of them to leave one for the single step
+    QRandomGenerator generator(11);
+    QVector<Position> positions(301);
+    for (int n = 0; n < positions.length(); ++n)
+    {
+        randomizePosition(generator);
+        positions[n] = _state->getPosition();
+    }
+
+    BatchEvaluator::Kernel kernels[3] = {BatchEvaluator::SCALAR, BatchEvaluator::SSE41, BatchEvaluator::AVX2};
+    for (BatchEvaluator::Kernel kernel : kernels) // kernels missing from the processor fall back to the scalar one
+    {
+        QVector<EvaluationTerms> terms(positions.length());
+        evaluator.evaluate(positions.data(), positions.length(), terms.data(), kernel);
+
+        for (int n = 0; n < positions.length(); ++n)
+        {
+            int piece_square = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                for (int field = 0; field < 16; ++field)
+                {
+                    Color color = positions[n].getField(i, field/4, field%4);
+                    piece_square += color == WHITE ? i*100 + field : color == BLACK ? -(i*10 + field*3) : 0;
+                }
+            }
+            QVERIFY2(terms[n].piece_square == piece_square, "Piece-square score does not match the pieces");
+
+            for (int color = 0; color < 2; ++color)
+            {
+                int min = 16;
+                for (int i = 0; i < 4; ++i)
+                {
+                    QVERIFY2(terms[n].counts[i][color] == positions[n].getPieceCount(i, static_cast<Color>(color)), "Piece count does not match the pieces");
+                    min = qMin(min, positions[n].getPieceCount(i, static_cast<Color>(color)));
+                }
+                QVERIFY2(terms[n].min_count[color] == min, "Weakest board count is not the minimum");
+                for (int i = 0; i < 4; ++i)
+                {
+                    QVERIFY2(bool(terms[n].min_boards[color] & (1 << i)) == (positions[n].getPieceCount(i, static_cast<Color>(color)) == min),
+                             "Weakest boards do not match the minimum");
+                }
+            }
+        }
+    }
+}
+
+// checks that parallelFor visits every index exactly once
+void ShobuTest::parallel_for()
+{
+    const int counts[] = {0, 1, 15, 16, 17, 174, 1000};
+    for (int count : counts)
+    {
+        for (int threads = 1; threads <= 5; threads += 2)
+        {
+            for (int chunk = 1; chunk <= 32; chunk *= 4)
+            {
+                QVector<std::atomic<int>> visits(count);
+                for (int i = 0; i < count; ++i)
+                {
+                    visits[i] = 0;
+                }
+                parallelFor(count, threads, chunk, [&](int begin, int end)
+                {
+                    QVERIFY2(begin < end && end - begin <= chunk, "Chunk has the wrong size");
+                    for (int i = begin; i < end; ++i)
+                    {
+                        ++visits[i];
+                    }
+                });
+                for (int i = 0; i < count; ++i)
+                {
+                    QVERIFY2(visits[i] == 1, "Index was not visited exactly once");
+                }
+            }
+        }
+    }
+}
+
+// Perft functions
+
+// checks the leaf counts from the starting state
+void ShobuTest::perft_count()
+{
+    Perft perft(_state);
+
+    QVERIFY2(perft.count(0) == 1, "Depth zero is not a single leaf");
+    QVERIFY2(perft.count(1) == 174, "Wrong number of moves from the starting state");
+    QVERIFY2(perft.count(2) == 28360, "Wrong number of leaves at depth 2");
+    QVERIFY2(perft.count(3) == 3848744, "Wrong number of leaves at depth 3");
+    QVERIFY2(perft.run(2).nodes == 28360, "Timed run counts different leaves");
+
+    QVERIFY2(_state->getTurn() == WHITE && _state->getPieceMask(0, WHITE) == 0xF000, "Counting changed the state");
+
+    QVERIFY_EXCEPTION_THROWN(perft.count(-1), ShobuException);
+}
+
+// checks the breakdown per root move
+void ShobuTest::perft_divide()
+{
+    Perft perft(_state);
+    QVector<PerftDivision> divisions = perft.divide(2);
+    QVector<Move> moves = _state->getMoves();
+
+    QVERIFY2(divisions.length() == moves.length(), "Not every root move is divided");
+
+    quint64 total = 0;
+    for (int i = 0; i < divisions.length(); ++i)
+    {
+        QVERIFY2(PackedMove(divisions[i].move) == PackedMove(moves[i]), "Divisions do not follow the move order");
+        total += divisions[i].nodes;
+    }
+    QVERIFY2(total == 28360, "Divisions do not add up to the leaf count");
+    QVERIFY2(perft.divide(0).isEmpty(), "Depth zero has root moves");
+}
+
+// checks counting from a loaded position
+void ShobuTest::perft_position()
+{
+    QVERIFY2(!Perft::loadPosition(_state, "bbbb"), "Short position is accepted");
+    QVERIFY2(!Perft::loadPosition(_state, QString(64, 'x') + "w"), "Unknown field is accepted");
+    QVERIFY2(!Perft::loadPosition(_state, QString(64, '.') + "x"), "Unknown color is accepted");
+
+    // white has one piece left on board 0, black can push it off
+    QString position = "b..." "...." "...." "...w"
+                       "bbbb" "...." "...." "wwww"
+                       "bbbb" "...." "...." "wwww"
+                       "bbbb" "...." "...." "wwww"
+                       "b";
+    QVERIFY2(Perft::loadPosition(_state, position), "Valid position is rejected");
+    QVERIFY2(_state->getTurn() == BLACK, "Color to move is not loaded");
+    QVERIFY2(_state->getPieceCount(0, WHITE) == 1 && _state->getPieceCount(0, BLACK) == 1, "Fields are not loaded");
+
+    Perft perft(_state);
+    QVERIFY2(perft.count(1) == static_cast<quint64>(_state->getMoves().length()), "Depth 1 is not the number of moves");
+
+    _state->setField(0,3,3,EMPTY);
+    QVERIFY2(perft.count(1) == 0, "Won state has moves counted");
+}
+
 // GameLogic children
 
 // checks the RandomLogic::getMove function
@@ -874,7 +1587,7 @@ void ShobuTest::random_legal()
     {
         Move move = _random->getMove();
         QVERIFY2(_state->isLegalMove(move), "Returned move is illegal");
-        _state->applyMove(move);
+        _state->push(move);
     }
 }
 
@@ -885,7 +1598,7 @@ void ShobuTest::greedy_legal()
     {
         Move move = _greedy->getMove();
         QVERIFY2(_state->isLegalMove(move), "Returned move is illegal");
-        _state->applyMove(move);
+        _state->push(move);
     }
 }
 
@@ -900,7 +1613,7 @@ void ShobuTest::hard_legal()
     {
         Move move = _hard[_state->getTurn()]->getMove();
         QVERIFY2(_state->isLegalMove(move), "Returned move is illegal");
-        _state->applyMove(move);
+        _state->push(move);
     }
 }
 
@@ -919,7 +1632,7 @@ void ShobuTest::greedy_beats_random()
         {
             Move move = _logics[_state->getTurn()]->getMove();
             QVERIFY2(_state->isLegalMove(move), "One of the logics attempted an illegal move");
-            _state->applyMove(move);
+            _state->push(move);
         }
 
         QVERIFY2(_state->getVictor() == BLACK, "The random logic won against the greedy logic. It is unlikely, but not entirely impossible");
@@ -944,7 +1657,7 @@ void ShobuTest::hard_beats_random()
         {
             Move move = _logics[_state->getTurn()]->getMove();
             QVERIFY2(_state->isLegalMove(move), "One of the logics attempted an illegal move");
-            _state->applyMove(move);
+            _state->push(move);
         }
 
         QVERIFY2(_state->getVictor() == BLACK, "The random logic won against the hard logic. It is unlikely, but not entirely impossible");
@@ -972,7 +1685,7 @@ void ShobuTest::hard_beats_greedy()
         {
             Move move = _logics[_state->getTurn()]->getMove();
             QVERIFY2(_state->isLegalMove(move), "One of the logics attempted an illegal move");
-            _state->applyMove(move);
+            _state->push(move);
         }
         if (_state->getVictor() == WHITE)
         {
@@ -985,6 +1698,260 @@ void ShobuTest::hard_beats_greedy()
                            "It is unlikely, but not entirely impossible");
 }
 
+// checks the greedy and hard logics with more threads than chunks and fewer
+void ShobuTest::parallel_logics()
+{
+    _greedy->setThreadCount(4);
+    _hard_white->setThreadCount(4);
+    _hard_black->setThreadCount(4);
+    QVERIFY2(_greedy->getThreadCount() == 4, "Thread count is not set");
+
+    MachineLogic *_logics[2];
+    _logics[BLACK] = _greedy;
+    _logics[WHITE] = _hard_white;
+
+    int stepcount = 0;
+    while (_state->getVictor() == EMPTY && stepcount++ < 40)
+    {
+        Move move = _logics[_state->getTurn()]->getMove();
+        QVERIFY2(_state->isLegalMove(move), "Returned move is illegal");
+        _state->push(move);
+    }
+
+    // a cancelled logic skips its chunks, but still returns a legal move
+    _state->initializeGame();
+    _greedy->cancel();
+    _hard_white->cancel();
+    QVERIFY2(_state->isLegalMove(_greedy->getMove()) && _state->isLegalMove(_hard_white->getMove()), "Cancelled logic returned an illegal move");
+    _greedy->clearCancel();
+    _hard_white->clearCancel();
+
+    // the winning push off is found whichever chunk it is in
+    setWinningPushPosition();
+
+    Move move = _hard_white->getMove();
+    _state->push(move);
+    QVERIFY2(_state->getVictor() == WHITE, "Hard logic missed the winning move");
+}
+
+// checks the SearchLogic::getMove function
+void ShobuTest::search_legal()
+{
+    _search->setTimeBudget(0);
+    _search->setNodeBudget(2000);
+
+    for (int i = 0; i < 10 && _state->getVictor() == EMPTY; ++i)
+    {
+        Move move = _search->getMove();
+        QVERIFY2(_state->isLegalMove(move), "Returned move is illegal");
+        _state->push(move);
+    }
+}
+
+// checks the node and time budgets of the SearchLogic
+void ShobuTest::search_budget()
+{
+    // the node budget is never exceeded
+    _search->setTimeBudget(0);
+    _search->setNodeBudget(5000);
+    _search->getMove();
+    QVERIFY2(_search->getNodeCount() <= 5000, "Search exceeded the node budget");
+    QVERIFY2(_search->getCompletedDepth() >= 1, "Search did not complete an iteration");
+
+    // the time budget is used up, the upper bound leaves room for slow machines
+    _search->setTimeBudget(200);
+    _search->setNodeBudget(0);
+    QElapsedTimer timer;
+    timer.start();
+    _search->getMove();
+    qint64 elapsed = timer.elapsed();
+    QVERIFY2(elapsed >= 200 && elapsed < 2000, "Search did not keep to the time budget");
+}
+
+// checks that the SearchLogic takes a winning push off
+void ShobuTest::search_finds_win()
+{
+    setWinningPushPosition();
+
+    _search->setTimeBudget(0);
+    _search->setNodeBudget(100000);
+    Move move = _search->getMove();
+    _state->push(move);
+    QVERIFY2(_state->getVictor() == WHITE, "Search missed the winning push");
+}
+
+// checks the SearchLogic with helper threads
+void ShobuTest::search_threads()
+{
+    _search->setThreadCount(4);
+    QVERIFY2(_search->getThreadCount() == 4, "Thread count is not set");
+
+    // helpers keep to the time budget of the first thread
+    _search->setTimeBudget(200);
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < 4 && _state->getVictor() == EMPTY; ++i)
+    {
+        Move move = _search->getMove();
+        QVERIFY2(_state->isLegalMove(move), "Returned move is illegal");
+        QVERIFY2(_search->getCompletedDepth() >= 1, "Search did not complete an iteration");
+        _state->push(move);
+    }
+    QVERIFY2(timer.elapsed() < 4 * 2000, "Helper threads did not stop in time");
+
+    // the shared table does not hide a win
+    _search->setTimeBudget(0);
+    _search->setNodeBudget(100000);
+    setWinningPushPosition();
+    _state->push(_search->getMove());
+    QVERIFY2(_state->getVictor() == WHITE, "Search missed the winning push");
+}
+
+// checks the expected move and the search without budget of the SearchLogic
+void ShobuTest::search_ponder()
+{
+    PackedMove expected;
+    QVERIFY2(!_search->getPonderMove(_state->getPosition(), expected), "Expected move given before any search");
+
+    _search->setTimeBudget(0);
+    _search->setNodeBudget(20000);
+    Move move = _search->getMove();
+    _state->push(move);
+    QVERIFY2(_search->getPonderMove(_state->getPosition(), expected), "No expected move after a search");
+    QVERIFY2(_state->isLegalMove(expected), "Expected move is illegal");
+    _state->push(expected);
+
+    // the budgets are ignored until the ponder hit, then the search stops on the time budget from its start
+    _search->setTimeBudget(50);
+    _search->setPondering(true);
+    QElapsedTimer timer;
+    timer.start();
+    std::thread ponder([&]() {move = _search->getMove();});
+    QTest::qWait(200);
+    _search->setPondering(false);
+    qint64 hit = timer.elapsed();
+    ponder.join();
+
+    QVERIFY2(hit >= 200, "Pondering did not wait for the hit");
+    QVERIFY2(timer.elapsed() - hit < 1000, "Search did not stop soon after the hit");
+    QVERIFY2(_state->isLegalMove(move), "Returned move is illegal");
+    QVERIFY2(_search->getCompletedDepth() >= 1, "Search did not complete an iteration");
+}
+
+// checks the storing, probing and replacement of the TranspositionTable
+void ShobuTest::transposition_table()
+{
+    TranspositionTable table(1);
+    QVERIFY2(table.getSize() == 1, "Table has the wrong size");
+
+    // entries come back as they were stored
+    TranspositionEntry entry;
+    PackedMove move(0, 5, 1, 6, 3, 2);
+    table.store(0x123456789ABCDEF0, 7, LOWER_BOUND, -4321, move);
+    QVERIFY2(table.probe(0x123456789ABCDEF0, entry), "Stored entry is not found");
+    QVERIFY2(entry.depth == 7 && entry.bound == LOWER_BOUND && entry.score == -4321 && entry.move == move, "Stored entry changed");
+    QVERIFY2(!table.probe(0x023456789ABCDEF0, entry), "Entry is found with another key");
+
+    // storing the same key without a move keeps the known move
+    table.store(0x123456789ABCDEF0, 8, EXACT_BOUND, 12, PackedMove(0));
+    QVERIFY2(table.probe(0x123456789ABCDEF0, entry) && entry.depth == 8 && entry.move == move, "Known move is lost");
+
+    // a full bucket gives up its shallowest entry
+    table.clear();
+    QVERIFY2(!table.probe(0x123456789ABCDEF0, entry), "Cleared table has entries");
+    int depths[5] = {10, 2, 8, 6, 4};
+    for (quint64 i = 0; i < 5; ++i)
+    {
+        table.store(5 + (i << 40), depths[i], EXACT_BOUND, 0, move);
+    }
+    for (quint64 i = 0; i < 5; ++i)
+    {
+        QVERIFY2(table.probe(5 + (i << 40), entry) == (i != 1), "Wrong entry was replaced");
+    }
+
+    // entries of older searches are replaced first
+    table.newSearch();
+    table.store(5 + (5ULL << 40), 1, EXACT_BOUND, 0, move);
+    QVERIFY2(!table.probe(5 + (4ULL << 40), entry) && table.probe(5 + (5ULL << 40), entry), "Old entry was not replaced");
+    QVERIFY2(table.probe(5, entry) && table.probe(5 + (2ULL << 40), entry), "Deep old entry was replaced");
+
+    table.resize(4);
+    QVERIFY2(table.getSize() == 4 && !table.probe(5, entry), "Resized table has the wrong size or keeps entries");
+}
+
+// checks the MonteCarloLogic::getMove function
+void ShobuTest::monte_carlo_legal()
+{
+    _monte_carlo->setTimeBudget(0);
+    _monte_carlo->setPlayoutBudget(500);
+    for (int i = 0; i < 8 && _state->getVictor() == EMPTY; ++i)
+    {
+        Move move = _monte_carlo->getMove();
+        QVERIFY2(_state->isLegalMove(move), "Returned move is illegal");
+        _state->push(move);
+    }
+}
+
+// checks the budgets of the MonteCarloLogic
+void ShobuTest::monte_carlo_budget()
+{
+    // the playout budget is kept exactly
+    _monte_carlo->setTimeBudget(0);
+    _monte_carlo->setPlayoutBudget(1000);
+    _monte_carlo->getMove();
+    QVERIFY2(_monte_carlo->getPlayoutCount() == 1000, "Search did not keep to the playout budget");
+    QVERIFY2(_monte_carlo->getRootVisits() == 1000, "Playouts were not counted at the root");
+    QVERIFY2(_monte_carlo->getNodeCount() > 1, "The tree did not grow");
+
+    // the time budget is used up, the upper bound leaves room for slow machines
+    _monte_carlo->setTimeBudget(200);
+    _monte_carlo->setPlayoutBudget(0);
+    _state->initializeGame();
+    QElapsedTimer timer;
+    timer.start();
+    _monte_carlo->getMove();
+    qint64 elapsed = timer.elapsed();
+    QVERIFY2(elapsed >= 200 && elapsed < 2000, "Search did not keep to the time budget");
+}
+
+// checks that the MonteCarloLogic takes a winning push off
+void ShobuTest::monte_carlo_finds_win()
+{
+    setWinningPushPosition();
+
+    _monte_carlo->setTimeBudget(0);
+    _monte_carlo->setPlayoutBudget(2000);
+    Move move = _monte_carlo->getMove();
+    _state->push(move);
+    QVERIFY2(_state->getVictor() == WHITE, "Search missed the winning push");
+}
+
+// checks that the tree is kept after the reply of the opponent
+void ShobuTest::monte_carlo_reuse()
+{
+    _monte_carlo->setTimeBudget(0);
+    _monte_carlo->setPlayoutBudget(5000);
+    Move move = _monte_carlo->getMove();
+    _state->push(move);
+
+    // the chosen move was expanded, so every reply is in the tree
+    Move reply = _greedy->getMove();
+    _state->push(reply);
+    _monte_carlo->getMove();
+    QVERIFY2(_monte_carlo->getPlayoutCount() == 5000, "Search did not keep to the playout budget");
+    QVERIFY2(_monte_carlo->getRootVisits() >= 5000, "Root visits were lost");
+
+    // the same position keeps the whole tree
+    int visits = _monte_carlo->getRootVisits();
+    _monte_carlo->getMove();
+    QVERIFY2(_monte_carlo->getRootVisits() == visits + 5000, "Tree of the same position was not kept");
+
+    // an unrelated position starts a new tree
+    _state->initializeGame();
+    _monte_carlo->getMove();
+    QVERIFY2(_monte_carlo->getRootVisits() == 5000, "Tree of an unrelated position was kept");
+}
+
 // check if MachinLogic::getMove throws an error if no legal moves are available
 void ShobuTest::machine_logic_error()
 {
@@ -998,6 +1965,8 @@ void ShobuTest::machine_logic_error()
     QVERIFY_EXCEPTION_THROWN(_random->getMove(), ShobuException);
     QVERIFY_EXCEPTION_THROWN(_greedy->getMove(), ShobuException);
     QVERIFY_EXCEPTION_THROWN(_hard_white->getMove(), ShobuException);
+    QVERIFY_EXCEPTION_THROWN(_search->getMove(), ShobuException);
+    QVERIFY_EXCEPTION_THROWN(_monte_carlo->getMove(), ShobuException);
 }
 
 // ShobuPlayer children
@@ -1064,7 +2033,7 @@ void ShobuTest::machine_moves()
     {
         machine[_state->getTurn()]->makeMove();
         QVERIFY2(_state->isLegalMove(_move.move), "The machine logic attempted an illegal move");
-        _state->applyMove(_move.move);
+        _state->push(_move.move);
     }
 
     for (int i = 0; i < 4; ++i) // block all passive moves
@@ -1076,6 +2045,116 @@ void ShobuTest::machine_moves()
     QVERIFY_EXCEPTION_THROWN(machine[WHITE]->makeMove(), ShobuException);
 }
 
+// checks that the pondering machine player goes on with its ponder search after a hit and searches again after a miss
+void ShobuTest::machine_ponder()
+{
+    MachinePlayer *machine = new MachinePlayer(&_move, WHITE, EXPERT, this);
+    machine->setPondering(true);
+    QSignalSpy spy(machine, &ShobuPlayer::moveMade);
+    Move expected;
+    QVERIFY2(!machine->getExpectedMove(expected), "Expected move given before pondering");
+
+    machine->makeMove();
+    QVERIFY2(spy.wait(5000), "The machine player did not make a move");
+    QVERIFY2(_state->isLegalMove(_move.move), "The machine logic attempted an illegal move");
+    _state->push(_move.move);
+
+    // the ponder search runs during the turn of the other player
+    machine->ponder();
+    QVERIFY2(machine->getExpectedMove(expected), "The machine player does not ponder");
+    QVERIFY2(_state->isLegalMove(expected), "Expected move is illegal");
+    QVERIFY2(machine->getSearchCount() == 2, "Pondering did not start a search");
+    QTest::qWait(300);
+    QVERIFY2(spy.count() == 1, "The machine player moved while pondering");
+
+    // a ponder hit starts no new search
+    _state->push(expected);
+    machine->makeMove();
+    QVERIFY2(machine->getSearchCount() == 2, "The ponder hit started a new search");
+    QVERIFY2(spy.wait(5000), "The machine player did not make a move after a ponder hit");
+    QVERIFY2(_state->isLegalMove(_move.move), "The machine logic attempted an illegal move");
+    _state->push(_move.move);
+
+    // a ponder miss starts a fresh search on the real position
+    machine->ponder();
+    QVERIFY2(machine->getExpectedMove(expected), "The machine player does not ponder");
+    QVERIFY2(machine->getSearchCount() == 3, "Pondering did not start a search");
+
+    MoveList moves;
+    _state->getMoves(moves);
+    Move reply = moves[0];
+    if (PackedMove(reply) == PackedMove(expected))
+    {
+        reply = moves[1];
+    }
+    _state->push(reply);
+    machine->makeMove();
+    QVERIFY2(machine->getSearchCount() == 4, "The ponder miss did not start a fresh search");
+    QVERIFY2(spy.wait(5000), "The machine player did not make a move after a ponder miss");
+    QVERIFY2(_state->isLegalMove(_move.move), "The machine logic attempted an illegal move");
+    _state->push(_move.move);
+
+    // does nothing on the turn of the machine player
+    _state->getMoves(moves);
+    _state->push(moves[0]);
+    machine->ponder();
+    QVERIFY2(!machine->getExpectedMove(expected), "The machine player pondered on its own turn");
+    QVERIFY2(machine->getSearchCount() == 4, "The machine player searched without a request");
+    QTest::qWait(300);
+    QVERIFY2(spy.count() == 3, "The machine player moved without a request");
+
+    machine->setPondering(false);
+    QVERIFY2(!machine->getPondering(), "Pondering was not turned off");
+    delete machine;
+}
+
+// checks that the expert machine player can search with the MonteCarloLogic
+void ShobuTest::machine_monte_carlo()
+{
+    MachinePlayer *machine = new MachinePlayer(&_move, WHITE, EXPERT, this);
+    QSignalSpy spy(machine, &ShobuPlayer::moveMade);
+
+    machine->setMonteCarlo(true);
+    QVERIFY2(machine->getMonteCarlo(), "Monte Carlo search was not set");
+    machine->makeMove();
+    QVERIFY2(spy.wait(5000), "The machine player did not make a move");
+    QVERIFY2(_state->isLegalMove(_move.move), "The machine logic attempted an illegal move");
+    delete machine;
+
+    // the other difficulties keep their logic
+    machine = new MachinePlayer(&_move, WHITE, HARD, this);
+    machine->setMonteCarlo(true);
+    QVERIFY2(!machine->getMonteCarlo(), "Monte Carlo search was set below the expert difficulty");
+    delete machine;
+}
+
+// checks that the machine player searches on a worker thread and drops the moves of cancelled searches
+void ShobuTest::machine_async()
+{
+    QSignalSpy spy(_machine_white, &ShobuPlayer::moveMade);
+
+    _machine_white->makeMove();
+    QVERIFY2(spy.wait(5000), "The machine player did not make a move");
+    QVERIFY2(_move.passive_set && _move.vector_set, "The move of the machine player was not set");
+    QVERIFY2(_state->isLegalMove(_move.move), "The machine logic attempted an illegal move");
+
+    // a cancelled search does not report its move
+    _move.passive_set = false;
+    _move.vector_set  = false;
+    _machine_white->makeMove();
+    _machine_white->cancelMove();
+    QTest::qWait(100);
+    QVERIFY2(spy.count() == 1, "A cancelled search reported its move");
+    QVERIFY2(!_move.passive_set, "A cancelled search set its move");
+
+    // a new search replaces the one in progress
+    _machine_white->makeMove();
+    _machine_white->makeMove();
+    QVERIFY2(spy.wait(5000), "The machine player did not make a move after a replaced search");
+    QTest::qWait(100);
+    QVERIFY2(spy.count() == 2, "A replaced search reported its move");
+}
+
 // ShobuModel functions
 
 // checks the ShobuModel::setSettings function